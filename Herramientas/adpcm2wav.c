@@ -0,0 +1,194 @@
+/**
+ * @file adpcm2wav.c
+ * @brief Herramienta de PC para convertir audio IMA-ADPCM guardado por el módulo a WAV
+ *
+ * Lee la memoria del modo continuo y escribe un WAV PCM de 16 bits mono por
+ * evento. Cada evento es una línea "Event: ...", sus bloques IMA-ADPCM y una
+ * línea "EventEnd: ..." (ver monitor.h). Las memorias grabadas antes, con las
+ * líneas rellenadas con espacios hasta ADPCM_BLOCK_BYTES, se leen igual. Un bloque se reconoce porque su tercer
+ * byte es un índice de paso (0 a 88) y el cuarto es 0; todo lo demás se lee
+ * como texto hasta el salto de línea, así también se saltan los registros de
+ * las mediciones manuales. El WAV se recorta a las muestras que indica el
+ * encabezado menos las perdidas del pie. Un archivo con solo bloques (sin
+ * líneas de texto) se convierte en un único WAV.
+ *
+ * Compilación: gcc -I../Librerias adpcm2wav.c ../Librerias/adpcm.c -o adpcm2wav
+ * Uso: adpcm2wav memoria.bin evento.wav [frecuencia_muestreo]
+ *      (escribe evento_1.wav, evento_2.wav, ...)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "adpcm.h"
+
+#define DEFAULT_SAMPLE_RATE 16000 ///< Frecuencia del modo continuo (MONITOR_SAMPLE_RATE)
+#define MAX_LINE 1024             ///< Línea de texto más larga que se lee
+
+/**
+ * @brief Evento en construcción
+ */
+typedef struct {
+    int16_t *pcm;          ///< Muestras decodificadas
+    uint32_t count;        ///< Muestras en pcm
+    uint32_t capacity;
+    uint32_t sample_rate;  ///< Del campo "Fs" del encabezado
+    uint32_t samples;      ///< Del campo "Samples" del encabezado (0 si no hay encabezado)
+} event_t;
+
+/**
+ * @brief Escribe un entero little-endian de n bytes
+ */
+static void put_le(FILE *f, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        fputc((value >> (8 * i)) & 0xFF, f);
+    }
+}
+
+/**
+ * @brief Escribe el encabezado de un WAV PCM 16 bits mono
+ */
+static void write_wav_header(FILE *f, uint32_t sample_rate, uint32_t samples) {
+    uint32_t data_bytes = samples * 2;
+    fwrite("RIFF", 1, 4, f);
+    put_le(f, 36 + data_bytes, 4);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put_le(f, 16, 4);              // Tamaño del bloque fmt
+    put_le(f, 1, 2);               // PCM
+    put_le(f, 1, 2);               // Mono
+    put_le(f, sample_rate, 4);
+    put_le(f, sample_rate * 2, 4); // Bytes por segundo
+    put_le(f, 2, 2);               // Block align
+    put_le(f, 16, 2);              // Bits por muestra
+    fwrite("data", 1, 4, f);
+    put_le(f, data_bytes, 4);
+}
+
+/**
+ * @brief Valor numérico de un campo "Nombre: valor" de una línea, o fallback
+ */
+static uint32_t field(const char *line, const char *name, uint32_t fallback) {
+    const char *p = strstr(line, name);
+    return p ? (uint32_t)strtoul(p + strlen(name), NULL, 10) : fallback;
+}
+
+/**
+ * @brief Escribe el evento como WAV y lo vacía
+ *
+ * @param keep Muestras a conservar (las demás son relleno del último bloque)
+ * @return true si se escribió un archivo
+ */
+static bool event_write(event_t *ev, const char *prefix, int number, uint32_t keep) {
+    if (ev->count == 0) {
+        return false;
+    }
+    if (keep > ev->count) {
+        keep = ev->count;
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s_%d.wav", prefix, number);
+    FILE *out = fopen(path, "wb");
+    if (!out) {
+        perror(path);
+        ev->count = 0;
+        return false;
+    }
+    write_wav_header(out, ev->sample_rate, keep);
+    for (uint32_t i = 0; i < keep; i++) {
+        put_le(out, (uint16_t)ev->pcm[i], 2);
+    }
+    fclose(out);
+    printf("%s: %lu muestras a %lu Hz\n", path, (unsigned long)keep, (unsigned long)ev->sample_rate);
+    ev->count = 0;
+    return true;
+}
+
+static void event_decode(event_t *ev, const uint8_t *block) {
+    if (ev->count + ADPCM_BLOCK_SAMPLES > ev->capacity) {
+        ev->capacity = ev->capacity ? ev->capacity * 2 : 64 * ADPCM_BLOCK_SAMPLES;
+        ev->pcm = realloc(ev->pcm, ev->capacity * sizeof(int16_t));
+    }
+    adpcm_decode_block(block, &ev->pcm[ev->count]);
+    ev->count += ADPCM_BLOCK_SAMPLES;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s memoria.bin evento.wav [frecuencia_muestreo]\n", argv[0]);
+        return 1;
+    }
+    uint32_t default_rate = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 10) : DEFAULT_SAMPLE_RATE;
+
+    char prefix[400];
+    snprintf(prefix, sizeof(prefix), "%s", argv[2]);
+    size_t len = strlen(prefix);
+    if (len > 4 && strcmp(prefix + len - 4, ".wav") == 0) {
+        prefix[len - 4] = '\0';
+    }
+
+    FILE *in = fopen(argv[1], "rb");
+    if (!in) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    event_t ev = { NULL, 0, 0, default_rate, 0 };
+    uint8_t block[ADPCM_BLOCK_BYTES];
+    char line[MAX_LINE];
+    int written = 0;
+
+    size_t got;
+    while ((got = fread(block, 1, ADPCM_HEADER_BYTES, in)) == ADPCM_HEADER_BYTES) {
+        if (block[3] == 0 && block[2] <= 88) {
+            if (fread(block + ADPCM_HEADER_BYTES, 1, ADPCM_BLOCK_BYTES - ADPCM_HEADER_BYTES, in) != ADPCM_BLOCK_BYTES - ADPCM_HEADER_BYTES) {
+                fprintf(stderr, "Bloque truncado al final de %s\n", argv[1]);
+                break;
+            }
+            event_decode(&ev, block);
+            continue;
+        }
+
+        // Línea de texto: los cuatro bytes ya leídos y el resto hasta '\n'
+        memcpy(line, block, ADPCM_HEADER_BYTES);
+        size_t n = ADPCM_HEADER_BYTES;
+        const char *newline = memchr(line, '\n', n);
+        if (newline) {
+            // Línea más corta que cuatro bytes: se devuelve lo que sigue
+            n = (size_t)(newline - line) + 1;
+            fseek(in, (long)n - ADPCM_HEADER_BYTES, SEEK_CUR);
+        } else {
+            int c;
+            while (n < sizeof(line) - 1 && (c = fgetc(in)) != EOF) {
+                line[n++] = (char)c;
+                if (c == '\n') {
+                    break;
+                }
+            }
+        }
+        line[n] = '\0';
+
+        if (strncmp(line, "EventEnd:", 9) == 0) {
+            uint32_t lost = field(line, "Lost: ", 0);
+            uint32_t keep = ev.samples > lost ? ev.samples - lost : ev.count;
+            written += event_write(&ev, prefix, written + 1, keep);
+            ev.samples = 0;
+        } else if (strncmp(line, "Event:", 6) == 0) {
+            // Un evento sin pie (memoria cortada) se guarda completo
+            written += event_write(&ev, prefix, written + 1, ev.count);
+            ev.sample_rate = field(line, "Fs: ", default_rate);
+            ev.samples = field(line, "Samples: ", 0);
+        }
+    }
+    if (got > 0 && got < ADPCM_HEADER_BYTES) {
+        fprintf(stderr, "Datos truncados al final de %s\n", argv[1]);
+    }
+    written += event_write(&ev, prefix, written + 1, ev.samples ? ev.samples : ev.count);
+
+    fclose(in);
+    free(ev.pcm);
+    printf("%d archivos WAV escritos\n", written);
+    return 0;
+}
@@ -0,0 +1,226 @@
+/**
+ * @file adpcm_bench.c
+ * @brief Herramienta de PC que mide la calidad y el costo del codificador IMA-ADPCM
+ *
+ * Codifica señales de 12 bits como las del ADC (tonos a varios niveles, un
+ * barrido y ruido, o archivos WAV de 16 bits mono), las decodifica y compara
+ * con la entrada del codificador: SNR en dB, relación de compresión y tiempo
+ * por muestra. Las muestras se entregan en trozos de MONITOR_COMMIT_CHUNK como
+ * lo hace monitor_task(). En x86 también se cuentan ciclos con el TSC.
+ *
+ * Compilación: gcc -O2 -I../Librerias adpcm_bench.c ../Librerias/adpcm.c -lm -o adpcm_bench
+ * Uso: adpcm_bench [clip.wav ...]
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "adpcm.h"
+#include "monitor.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#define SAMPLE_RATE MONITOR_SAMPLE_RATE ///< Frecuencia del modo continuo
+#define SIGNAL_SAMPLES (10 * SAMPLE_RATE) ///< Diez segundos por señal
+#define TIMING_ROUNDS 20                  ///< Repeticiones para medir el tiempo
+
+static uint8_t *encoded;      ///< Bloques producidos por el codificador
+static size_t encoded_blocks;
+
+static void collect_block(const uint8_t *block) {
+    memcpy(&encoded[encoded_blocks++ * ADPCM_BLOCK_BYTES], block, ADPCM_BLOCK_BYTES);
+}
+
+static void discard_block(const uint8_t *block) {
+    (void)block;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void encode_chunks(adpcm_encoder_t *enc, const uint16_t *adc, size_t count) {
+    for (size_t i = 0; i < count; i += MONITOR_COMMIT_CHUNK) {
+        size_t n = count - i < MONITOR_COMMIT_CHUNK ? count - i : MONITOR_COMMIT_CHUNK;
+        adpcm_encode(enc, &adc[i], n);
+    }
+    adpcm_flush(enc);
+}
+
+/**
+ * @brief Mide una señal de muestras del ADC e imprime una fila de la tabla
+ */
+static void measure(const char *name, const uint16_t *adc, size_t count) {
+    size_t blocks = (count + ADPCM_BLOCK_SAMPLES - 1) / ADPCM_BLOCK_SAMPLES;
+    encoded = malloc(blocks * ADPCM_BLOCK_BYTES);
+    encoded_blocks = 0;
+
+    adpcm_encoder_t enc;
+    adpcm_encoder_init(&enc, collect_block);
+    encode_chunks(&enc, adc, count);
+
+    // SNR contra la entrada del codificador (12 bits centrados y llevados a 16)
+    int16_t pcm[ADPCM_BLOCK_SAMPLES];
+    double signal = 0.0, noise = 0.0;
+    for (size_t b = 0; b < encoded_blocks; b++) {
+        adpcm_decode_block(&encoded[b * ADPCM_BLOCK_BYTES], pcm);
+        for (size_t i = 0; i < ADPCM_BLOCK_SAMPLES && b * ADPCM_BLOCK_SAMPLES + i < count; i++) {
+            double x = (double)(((int32_t)(adc[b * ADPCM_BLOCK_SAMPLES + i] & 0x0FFF) - 2048) << 4);
+            double e = x - pcm[i];
+            signal += x * x;
+            noise += e * e;
+        }
+    }
+    double snr = noise > 0.0 ? 10.0 * log10(signal / noise) : INFINITY;
+
+    uint64_t start = now_ns();
+#ifdef HAVE_TSC
+    uint64_t tsc = __rdtsc();
+#endif
+    for (int r = 0; r < TIMING_ROUNDS; r++) {
+        adpcm_encoder_init(&enc, discard_block);
+        encode_chunks(&enc, adc, count);
+    }
+#ifdef HAVE_TSC
+    double cycles = (double)(__rdtsc() - tsc) / ((double)TIMING_ROUNDS * count);
+#endif
+    double encode_ns = (double)(now_ns() - start) / ((double)TIMING_ROUNDS * count);
+
+    start = now_ns();
+    volatile int16_t sink = 0;
+    for (int r = 0; r < TIMING_ROUNDS; r++) {
+        for (size_t b = 0; b < encoded_blocks; b++) {
+            adpcm_decode_block(&encoded[b * ADPCM_BLOCK_BYTES], pcm);
+            sink += pcm[b % ADPCM_BLOCK_SAMPLES];
+        }
+    }
+    double decode_ns = (double)(now_ns() - start) / ((double)TIMING_ROUNDS * count);
+
+    printf("%-26s %7.1f dB  %5.2f:1  %6.2f ns", name, snr,
+        (double)count * 2 / (encoded_blocks * ADPCM_BLOCK_BYTES), encode_ns);
+#ifdef HAVE_TSC
+    printf("  %6.1f ciclos", cycles);
+#endif
+    printf("  %6.2f ns\n", decode_ns);
+    free(encoded);
+}
+
+/**
+ * @brief Muestra del ADC para un valor entre -1 y 1
+ */
+static uint16_t to_adc(double x) {
+    long v = lround(2048.0 + 2047.0 * x);
+    return (uint16_t)(v < 0 ? 0 : v > 4095 ? 4095 : v);
+}
+
+/**
+ * @brief Lee un WAV PCM de 16 bits mono como muestras del ADC (12 bits)
+ *
+ * @return Muestras leídas (0 si el archivo no sirve)
+ */
+static size_t read_wav(const char *path, uint16_t **adc) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 0;
+    }
+    uint8_t riff[12], chunk[8];
+    uint16_t format = 0, channels = 0, bits = 0;
+    size_t count = 0;
+    if (fread(riff, 1, 12, f) != 12 || memcmp(riff, "RIFF", 4) || memcmp(riff + 8, "WAVE", 4)) {
+        fprintf(stderr, "%s: no es un WAV\n", path);
+        fclose(f);
+        return 0;
+    }
+    while (fread(chunk, 1, 8, f) == 8) {
+        uint32_t size = chunk[4] | chunk[5] << 8 | chunk[6] << 16 | (uint32_t)chunk[7] << 24;
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[16];
+            if (size < 16 || fread(fmt, 1, 16, f) != 16) {
+                break;
+            }
+            format = fmt[0] | fmt[1] << 8;
+            channels = fmt[2] | fmt[3] << 8;
+            bits = fmt[14] | fmt[15] << 8;
+            fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (format != 1 || channels != 1 || bits != 16) {
+                fprintf(stderr, "%s: se espera PCM de 16 bits mono\n", path);
+                break;
+            }
+            count = size / 2;
+            *adc = malloc(count * sizeof(uint16_t));
+            for (size_t i = 0; i < count; i++) {
+                uint8_t s[2];
+                if (fread(s, 1, 2, f) != 2) {
+                    count = i;
+                    break;
+                }
+                (*adc)[i] = (uint16_t)(((int16_t)(s[0] | s[1] << 8) >> 4) + 2048);
+            }
+            break;
+        } else {
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    return count;
+}
+
+int main(int argc, char *argv[]) {
+    uint16_t *adc = malloc(SIGNAL_SAMPLES * sizeof(uint16_t));
+    const double levels_db[] = { -1.0, -20.0, -40.0 };
+    char name[64];
+
+    printf("%-27s %10s  %6s  %9s", "Señal", "SNR", "Comp.", "Codif.");
+#ifdef HAVE_TSC
+    printf("  %13s", "Codif. (TSC)");
+#endif
+    printf("  %9s\n", "Decodif.");
+
+    for (size_t l = 0; l < sizeof(levels_db) / sizeof(levels_db[0]); l++) {
+        double amplitude = pow(10.0, levels_db[l] / 20.0);
+        for (size_t i = 0; i < SIGNAL_SAMPLES; i++) {
+            adc[i] = to_adc(amplitude * sin(2.0 * M_PI * 1000.0 * i / SAMPLE_RATE));
+        }
+        snprintf(name, sizeof(name), "Tono 1 kHz %.0f dBFS", levels_db[l]);
+        measure(name, adc, SIGNAL_SAMPLES);
+    }
+
+    // Barrido lineal de 50 Hz a 7.5 kHz a -6 dBFS
+    double phase = 0.0;
+    for (size_t i = 0; i < SIGNAL_SAMPLES; i++) {
+        double f = 50.0 + (7500.0 - 50.0) * i / SIGNAL_SAMPLES;
+        phase += 2.0 * M_PI * f / SAMPLE_RATE;
+        adc[i] = to_adc(0.5 * sin(phase));
+    }
+    measure("Barrido 50 Hz-7.5 kHz", adc, SIGNAL_SAMPLES);
+
+    // Ruido blanco uniforme a -10 dBFS de pico
+    srand(1);
+    for (size_t i = 0; i < SIGNAL_SAMPLES; i++) {
+        adc[i] = to_adc(0.316 * (2.0 * rand() / RAND_MAX - 1.0));
+    }
+    measure("Ruido blanco", adc, SIGNAL_SAMPLES);
+    free(adc);
+
+    for (int a = 1; a < argc; a++) {
+        uint16_t *clip = NULL;
+        size_t count = read_wav(argv[a], &clip);
+        if (count) {
+            measure(argv[a], clip, count);
+        }
+        free(clip);
+    }
+
+    printf("Presupuesto a %d Hz: %.0f ns por muestra\n", SAMPLE_RATE, 1e9 / SAMPLE_RATE);
+    return 0;
+}
@@ -0,0 +1,555 @@
+/**
+ * @file clasificador.c
+ * @brief Herramienta de PC para entrenar y evaluar el clasificador de fuentes de ruido
+ *
+ * Lee una lista de clips WAV etiquetados (una línea "ruta.wav etiqueta" por
+ * clip, rutas relativas a la lista) y calcula las características de cada
+ * bloque con el mismo código del firmware (audio_features.c).
+ *
+ *  - train: entrena en punto flotante una red de una capa oculta, la cuantiza
+ *    a int8 y escribe classifier_weights.h. Informa la exactitud del modelo
+ *    flotante y la del cuantizado, calculada con classifier_infer().
+ *  - eval: evalúa el modelo compilado en classifier_weights.h: exactitud por
+ *    bloque y por clip, matriz de confusión y tiempo por bloque en el PC.
+ *
+ * Los WAV deben ser PCM de 16 bits, mono, a 16 kHz (MONITOR_SAMPLE_RATE).
+ *
+ * Compilación (SDK de Pico con PICO_PLATFORM=host, como replay.c):
+ *   gcc -O2 -I../Librerias clasificador.c ../Librerias/classifier.c
+ *       ../Librerias/audio_features.c ../Librerias/kernels.c -lm -o clasificador
+ *
+ * Uso: clasificador train lista.txt ../Librerias/classifier_weights.h
+ *      clasificador eval lista.txt
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "classifier.h"
+#include "audio_features.h"
+
+#define SAMPLE_RATE 16000    ///< Frecuencia de los clips
+#define EPOCHS 60            ///< Pasadas de entrenamiento
+#define LEARNING_RATE 0.01f  ///< Paso del descenso de gradiente
+#define INPUT_STEPS 32.0f    ///< Pasos de int8 por desviación estándar de cada característica
+
+/**
+ * @brief Bloque de un clip con sus características
+ */
+typedef struct {
+    int32_t features[FEATURE_COUNT];
+    float x[FEATURE_COUNT]; ///< Características normalizadas (solo para entrenar)
+    int label;
+    int clip;
+} sample_t;
+
+static sample_t *samples;
+static size_t sample_count;
+static size_t sample_capacity;
+static int clip_count;
+static int *clip_labels;
+static char labels[CLASSIFIER_MAX_CLASSES][CLASSIFIER_LABEL_LEN];
+static int label_count;
+
+// Modelo flotante
+static float w1[CLASSIFIER_HIDDEN][FEATURE_COUNT], b1[CLASSIFIER_HIDDEN];
+static float w2[CLASSIFIER_MAX_CLASSES][CLASSIFIER_HIDDEN], b2[CLASSIFIER_MAX_CLASSES];
+
+static uint32_t rng_state = 12345;
+
+/**
+ * @brief Generador pseudoaleatorio fijo para que el entrenamiento sea repetible
+ */
+static float rng_uniform(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (rng_state >> 8) / 16777216.0f;
+}
+
+static uint32_t read_le(const uint8_t *p, int bytes) {
+    uint32_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+/**
+ * @brief Busca una etiqueta; la agrega si create es verdadero
+ *
+ * @return Índice de la etiqueta, o -1 si no existe o no hay lugar
+ */
+static int label_index(const char *name, int create) {
+    for (int i = 0; i < label_count; i++) {
+        if (strcmp(labels[i], name) == 0) {
+            return i;
+        }
+    }
+    if (!create || label_count == CLASSIFIER_MAX_CLASSES || strlen(name) >= CLASSIFIER_LABEL_LEN) {
+        return -1;
+    }
+    strcpy(labels[label_count], name);
+    return label_count++;
+}
+
+/**
+ * @brief Lee un WAV y agrega las características de cada bloque completo
+ *
+ * @return 0 si todo está bien, 1 si hay un error (ya reportado)
+ */
+static int load_clip(const char *path, int label) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(size);
+    if (fread(data, 1, size, f) != (size_t)size || size < 12 || memcmp(data, "RIFF", 4) || memcmp(data + 8, "WAVE", 4)) {
+        fprintf(stderr, "%s no es un WAV\n", path);
+        fclose(f);
+        free(data);
+        return 1;
+    }
+    fclose(f);
+
+    const uint8_t *pcm = NULL;
+    uint32_t pcm_bytes = 0;
+    int format_ok = 0;
+    for (long pos = 12; pos + 8 <= size;) {
+        uint32_t chunk = read_le(data + pos + 4, 4);
+        if (memcmp(data + pos, "fmt ", 4) == 0 && chunk >= 16) {
+            format_ok = read_le(data + pos + 8, 2) == 1 && read_le(data + pos + 10, 2) == 1 &&
+                read_le(data + pos + 12, 4) == SAMPLE_RATE && read_le(data + pos + 22, 2) == 16;
+        } else if (memcmp(data + pos, "data", 4) == 0) {
+            pcm = data + pos + 8;
+            pcm_bytes = chunk <= (uint32_t)(size - pos - 8) ? chunk : (uint32_t)(size - pos - 8);
+        }
+        pos += 8 + chunk + (chunk & 1);
+    }
+    if (!format_ok || !pcm) {
+        fprintf(stderr, "%s: se requiere PCM de 16 bits, mono, a %d Hz\n", path, SAMPLE_RATE);
+        free(data);
+        return 1;
+    }
+
+    // El clip se convierte a lo que entregaría el ADC de 12 bits centrado en 2048
+    features_state_t state;
+    features_init(&state);
+    uint16_t block[FEATURE_BLOCK_SAMPLES];
+    uint32_t count = pcm_bytes / 2;
+    for (uint32_t start = 0; start + FEATURE_BLOCK_SAMPLES <= count; start += FEATURE_BLOCK_SAMPLES) {
+        for (int i = 0; i < FEATURE_BLOCK_SAMPLES; i++) {
+            int16_t s = (int16_t)read_le(pcm + 2 * (start + i), 2);
+            block[i] = (uint16_t)((s >> 4) + 2048);
+        }
+        if (sample_count == sample_capacity) {
+            sample_capacity = sample_capacity ? sample_capacity * 2 : 4096;
+            samples = realloc(samples, sample_capacity * sizeof(*samples));
+        }
+        sample_t *s = &samples[sample_count++];
+        features_block(&state, block, s->features);
+        s->label = label;
+        s->clip = clip_count;
+    }
+    clip_labels = realloc(clip_labels, (clip_count + 1) * sizeof(int));
+    clip_labels[clip_count++] = label;
+    free(data);
+    return 0;
+}
+
+/**
+ * @brief Lee la lista de clips
+ *
+ * @param create Si es verdadero las etiquetas nuevas se agregan; si no, deben
+ *               existir en labels (las del modelo compilado)
+ */
+static int load_list(const char *list_path, int create) {
+    FILE *list = fopen(list_path, "r");
+    if (!list) {
+        perror(list_path);
+        return 1;
+    }
+    char dir[512] = "";
+    const char *slash = strrchr(list_path, '/');
+    if (slash && (size_t)(slash - list_path) < sizeof(dir) - 1) {
+        memcpy(dir, list_path, slash - list_path + 1);
+        dir[slash - list_path + 1] = '\0';
+    }
+
+    char line[600], name[512], label[64];
+    while (fgets(line, sizeof(line), list)) {
+        if (line[0] == '#' || sscanf(line, "%511s %63s", name, label) != 2) {
+            continue;
+        }
+        int index = label_index(label, create);
+        if (index < 0) {
+            fprintf(stderr, "Etiqueta desconocida o sobrante: %s\n", label);
+            fclose(list);
+            return 1;
+        }
+        char path[1100];
+        snprintf(path, sizeof(path), "%s%s", name[0] == '/' ? "" : dir, name);
+        if (load_clip(path, index)) {
+            fclose(list);
+            return 1;
+        }
+    }
+    fclose(list);
+    if (sample_count == 0 || label_count < 2) {
+        fprintf(stderr, "%s: se necesitan bloques de al menos dos clases\n", list_path);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Propagación hacia adelante del modelo flotante
+ */
+static void float_forward(const float *x, float *hidden, float *probs) {
+    for (int h = 0; h < CLASSIFIER_HIDDEN; h++) {
+        float acc = b1[h];
+        for (int i = 0; i < FEATURE_COUNT; i++) {
+            acc += w1[h][i] * x[i];
+        }
+        hidden[h] = acc > 0 ? acc : 0;
+    }
+    float max = -INFINITY, sum = 0;
+    for (int c = 0; c < label_count; c++) {
+        float acc = b2[c];
+        for (int h = 0; h < CLASSIFIER_HIDDEN; h++) {
+            acc += w2[c][h] * hidden[h];
+        }
+        probs[c] = acc;
+        max = acc > max ? acc : max;
+    }
+    for (int c = 0; c < label_count; c++) {
+        probs[c] = expf(probs[c] - max);
+        sum += probs[c];
+    }
+    for (int c = 0; c < label_count; c++) {
+        probs[c] /= sum;
+    }
+}
+
+static int argmax_f(const float *v, int n) {
+    int best = 0;
+    for (int i = 1; i < n; i++) {
+        best = v[i] > v[best] ? i : best;
+    }
+    return best;
+}
+
+static int argmax_u(const uint32_t *v, int n) {
+    int best = 0;
+    for (int i = 1; i < n; i++) {
+        best = v[i] > v[best] ? i : best;
+    }
+    return best;
+}
+
+/**
+ * @brief Entrena con descenso de gradiente por muestra y clases balanceadas
+ */
+static void train(float mean[FEATURE_COUNT], float std[FEATURE_COUNT]) {
+    for (int i = 0; i < FEATURE_COUNT; i++) {
+        double s = 0, s2 = 0;
+        for (size_t n = 0; n < sample_count; n++) {
+            s += samples[n].features[i];
+            s2 += (double)samples[n].features[i] * samples[n].features[i];
+        }
+        mean[i] = (float)(s / sample_count);
+        std[i] = (float)sqrt(s2 / sample_count - (s / sample_count) * (s / sample_count));
+        if (std[i] < 1.0f) {
+            std[i] = 1.0f;
+        }
+    }
+    for (size_t n = 0; n < sample_count; n++) {
+        for (int i = 0; i < FEATURE_COUNT; i++) {
+            samples[n].x[i] = (samples[n].features[i] - mean[i]) / std[i];
+        }
+    }
+
+    float class_weight[CLASSIFIER_MAX_CLASSES] = { 0 };
+    for (size_t n = 0; n < sample_count; n++) {
+        class_weight[samples[n].label] += 1.0f;
+    }
+    for (int c = 0; c < label_count; c++) {
+        class_weight[c] = class_weight[c] > 0 ? sample_count / (label_count * class_weight[c]) : 0;
+    }
+
+    float r1 = sqrtf(6.0f / (FEATURE_COUNT + CLASSIFIER_HIDDEN));
+    float r2 = sqrtf(6.0f / (CLASSIFIER_HIDDEN + label_count));
+    for (int h = 0; h < CLASSIFIER_HIDDEN; h++) {
+        for (int i = 0; i < FEATURE_COUNT; i++) {
+            w1[h][i] = (2 * rng_uniform() - 1) * r1;
+        }
+        b1[h] = 0.1f;
+    }
+    for (int c = 0; c < label_count; c++) {
+        for (int h = 0; h < CLASSIFIER_HIDDEN; h++) {
+            w2[c][h] = (2 * rng_uniform() - 1) * r2;
+        }
+    }
+
+    size_t *order = malloc(sample_count * sizeof(size_t));
+    for (size_t n = 0; n < sample_count; n++) {
+        order[n] = n;
+    }
+    for (int epoch = 0; epoch < EPOCHS; epoch++) {
+        for (size_t n = sample_count - 1; n > 0; n--) {
+            size_t k = (size_t)(rng_uniform() * (n + 1));
+            size_t t = order[n];
+            order[n] = order[k];
+            order[k] = t;
+        }
+        for (size_t n = 0; n < sample_count; n++) {
+            const sample_t *s = &samples[order[n]];
+            float hidden[CLASSIFIER_HIDDEN], probs[CLASSIFIER_MAX_CLASSES], grad_out[CLASSIFIER_MAX_CLASSES];
+            float_forward(s->x, hidden, probs);
+            float lr = LEARNING_RATE * class_weight[s->label];
+            for (int c = 0; c < label_count; c++) {
+                grad_out[c] = probs[c] - (c == s->label);
+            }
+            for (int h = 0; h < CLASSIFIER_HIDDEN; h++) {
+                float grad_h = 0;
+                for (int c = 0; c < label_count; c++) {
+                    grad_h += grad_out[c] * w2[c][h];
+                    w2[c][h] -= lr * grad_out[c] * hidden[h];
+                }
+                if (hidden[h] > 0) {
+                    for (int i = 0; i < FEATURE_COUNT; i++) {
+                        w1[h][i] -= lr * grad_h * s->x[i];
+                    }
+                    b1[h] -= lr * grad_h;
+                }
+            }
+            for (int c = 0; c < label_count; c++) {
+                b2[c] -= lr * grad_out[c];
+            }
+        }
+    }
+    free(order);
+}
+
+static int8_t quantize(float value, float scale) {
+    long q = lroundf(value / scale);
+    return (int8_t)(q < -127 ? -127 : q > 127 ? 127 : q);
+}
+
+/**
+ * @brief Cuantiza el modelo flotante al formato de classifier_model_t
+ */
+static void quantize_model(const float mean[FEATURE_COUNT], const float std[FEATURE_COUNT], classifier_model_t *m) {
+    memset(m, 0, sizeof(*m));
+    m->class_count = (uint8_t)label_count;
+    memcpy(m->labels, labels, sizeof(labels));
+
+    const float s_in = 1.0f / INPUT_STEPS;
+    for (int i = 0; i < FEATURE_COUNT; i++) {
+        m->in_offset[i] = (int32_t)lroundf(mean[i]);
+        m->in_mult_q16[i] = (int32_t)lroundf(65536.0f * INPUT_STEPS / std[i]);
+    }
+
+    float max_w1 = 1e-6f, max_w2 = 1e-6f, max_hidden = 1e-6f;
+    for (int h = 0; h < CLASSIFIER_HIDDEN; h++) {
+        for (int i = 0; i < FEATURE_COUNT; i++) {
+            max_w1 = fmaxf(max_w1, fabsf(w1[h][i]));
+        }
+        for (int c = 0; c < label_count; c++) {
+            max_w2 = fmaxf(max_w2, fabsf(w2[c][h]));
+        }
+    }
+    for (size_t n = 0; n < sample_count; n++) {
+        float hidden[CLASSIFIER_HIDDEN], probs[CLASSIFIER_MAX_CLASSES];
+        float_forward(samples[n].x, hidden, probs);
+        for (int h = 0; h < CLASSIFIER_HIDDEN; h++) {
+            max_hidden = fmaxf(max_hidden, hidden[h]);
+        }
+    }
+
+    float s_w1 = max_w1 / 127, s_w2 = max_w2 / 127, s_h = max_hidden / 127;
+    for (int h = 0; h < CLASSIFIER_HIDDEN; h++) {
+        for (int i = 0; i < FEATURE_COUNT; i++) {
+            m->w1[h][i] = quantize(w1[h][i], s_w1);
+        }
+        m->b1[h] = (int32_t)lroundf(b1[h] / (s_in * s_w1));
+    }
+    m->hidden_mult_q16 = (int32_t)lroundf(65536.0f * s_in * s_w1 / s_h);
+    for (int c = 0; c < label_count; c++) {
+        for (int h = 0; h < CLASSIFIER_HIDDEN; h++) {
+            m->w2[c][h] = quantize(w2[c][h], s_w2);
+        }
+        m->b2[c] = (int32_t)lroundf(b2[c] / (s_h * s_w2));
+    }
+    m->out_mult_q16 = (int32_t)lroundf(65536.0f * 256.0f * s_h * s_w2);
+}
+
+static void write_array(FILE *out, const char *name, const int32_t *v, int n) {
+    fprintf(out, "    .%s = {", name);
+    for (int i = 0; i < n; i++) {
+        fprintf(out, "%s%ld", i ? ", " : " ", (long)v[i]);
+    }
+    fprintf(out, " },\n");
+}
+
+static void write_matrix(FILE *out, const char *name, const int8_t *v, int rows, int cols) {
+    fprintf(out, "    .%s = {\n", name);
+    for (int r = 0; r < rows; r++) {
+        fprintf(out, "        {");
+        for (int c = 0; c < cols; c++) {
+            fprintf(out, "%s%d", c ? ", " : " ", v[r * cols + c]);
+        }
+        fprintf(out, " },\n");
+    }
+    fprintf(out, "    },\n");
+}
+
+static int write_header(const char *path, const char *list_path, const classifier_model_t *m) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        perror(path);
+        return 1;
+    }
+    fprintf(out, "/**\n * @file classifier_weights.h\n * @brief Pesos del clasificador, generado por clasificador a partir de %s\n */\n\n", list_path);
+    fprintf(out, "#ifndef CLASSIFIER_WEIGHTS_H\n#define CLASSIFIER_WEIGHTS_H\n\n#include \"classifier.h\"\n\n");
+    fprintf(out, "static const classifier_model_t classifier_model = {\n");
+    fprintf(out, "    .class_count = %u,\n    .labels = {", m->class_count);
+    for (int c = 0; c < m->class_count; c++) {
+        fprintf(out, "%s\"%s\"", c ? ", " : " ", m->labels[c]);
+    }
+    fprintf(out, " },\n");
+    write_array(out, "in_offset", m->in_offset, CLASSIFIER_INPUTS);
+    write_array(out, "in_mult_q16", m->in_mult_q16, CLASSIFIER_INPUTS);
+    write_matrix(out, "w1", &m->w1[0][0], CLASSIFIER_HIDDEN, CLASSIFIER_INPUTS);
+    write_array(out, "b1", m->b1, CLASSIFIER_HIDDEN);
+    fprintf(out, "    .hidden_mult_q16 = %ld,\n", (long)m->hidden_mult_q16);
+    write_matrix(out, "w2", &m->w2[0][0], m->class_count, CLASSIFIER_HIDDEN);
+    write_array(out, "b2", m->b2, m->class_count);
+    fprintf(out, "    .out_mult_q16 = %ld,\n};\n\n#endif // CLASSIFIER_WEIGHTS_H\n", (long)m->out_mult_q16);
+    fclose(out);
+    return 0;
+}
+
+/**
+ * @brief Exactitud por bloque y por clip de un modelo cuantizado
+ *
+ * Por clip se promedian las probabilidades de todos sus bloques, como hace
+ * la media móvil del firmware durante un evento.
+ */
+static void evaluate(const classifier_model_t *m, const int *label_map) {
+    int confusion[CLASSIFIER_MAX_CLASSES][CLASSIFIER_MAX_CLASSES] = { { 0 } };
+    uint64_t *clip_sum = calloc((size_t)clip_count * CLASSIFIER_MAX_CLASSES, sizeof(uint64_t));
+    size_t block_hits = 0;
+    struct timespec t0, t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (size_t n = 0; n < sample_count; n++) {
+        uint32_t probs[CLASSIFIER_MAX_CLASSES];
+        classifier_infer(m, samples[n].features, probs);
+        int predicted = argmax_u(probs, m->class_count);
+        int truth = label_map[samples[n].label];
+        block_hits += predicted == truth;
+        for (int c = 0; c < m->class_count; c++) {
+            clip_sum[(size_t)samples[n].clip * CLASSIFIER_MAX_CLASSES + c] += probs[c];
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double infer_ns = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / sample_count;
+
+    int clip_hits = 0;
+    for (int k = 0; k < clip_count; k++) {
+        uint32_t avg[CLASSIFIER_MAX_CLASSES];
+        for (int c = 0; c < m->class_count; c++) {
+            avg[c] = (uint32_t)(clip_sum[(size_t)k * CLASSIFIER_MAX_CLASSES + c] >> 8);
+        }
+        int predicted = argmax_u(avg, m->class_count);
+        int truth = label_map[clip_labels[k]];
+        confusion[truth][predicted]++;
+        clip_hits += predicted == truth;
+    }
+    free(clip_sum);
+
+    printf("Bloques: %zu, exactitud %.1f%%\n", sample_count, 100.0 * block_hits / sample_count);
+    printf("Clips: %d, exactitud %.1f%%\n", clip_count, 100.0 * clip_hits / clip_count);
+    printf("Inferencia en el PC: %.0f ns por bloque (sin características)\n", infer_ns);
+    printf("Matriz de confusión por clip (filas: real, columnas: predicha)\n%14s", "");
+    for (int c = 0; c < m->class_count; c++) {
+        printf(" %13s", m->labels[c]);
+    }
+    printf("\n");
+    for (int r = 0; r < m->class_count; r++) {
+        printf("%14s", m->labels[r]);
+        for (int c = 0; c < m->class_count; c++) {
+            printf(" %13d", confusion[r][c]);
+        }
+        printf("\n");
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int train_mode = argc == 4 && strcmp(argv[1], "train") == 0;
+    int eval_mode = argc == 3 && strcmp(argv[1], "eval") == 0;
+    if (!train_mode && !eval_mode) {
+        fprintf(stderr, "Uso: %s train lista.txt classifier_weights.h\n     %s eval lista.txt\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    int label_map[CLASSIFIER_MAX_CLASSES];
+    const classifier_model_t *model = classifier_default_model();
+    if (eval_mode) {
+        // Las etiquetas de la lista deben ser las del modelo compilado
+        for (int c = 0; c < model->class_count; c++) {
+            label_index(model->labels[c], 1);
+        }
+    }
+    if (load_list(argv[2], train_mode)) {
+        return 1;
+    }
+    for (int c = 0; c < CLASSIFIER_MAX_CLASSES; c++) {
+        label_map[c] = c;
+    }
+
+    // Tiempo de las características, que en el firmware corren junto con la inferencia
+    struct timespec t0, t1;
+    features_state_t state;
+    uint16_t block[FEATURE_BLOCK_SAMPLES];
+    int32_t features[FEATURE_COUNT];
+    features_init(&state);
+    for (int i = 0; i < FEATURE_BLOCK_SAMPLES; i++) {
+        block[i] = (uint16_t)(2048 + (int)(rng_uniform() * 400) - 200);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < 20000; i++) {
+        features_block(&state, block, features);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("Características en el PC: %.0f ns por bloque\n", ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / 20000);
+
+    if (eval_mode) {
+        evaluate(model, label_map);
+        return 0;
+    }
+
+    float mean[FEATURE_COUNT], std[FEATURE_COUNT];
+    train(mean, std);
+
+    size_t hits = 0;
+    for (size_t n = 0; n < sample_count; n++) {
+        float hidden[CLASSIFIER_HIDDEN], probs[CLASSIFIER_MAX_CLASSES];
+        float_forward(samples[n].x, hidden, probs);
+        hits += argmax_f(probs, label_count) == samples[n].label;
+    }
+    printf("Modelo flotante: exactitud por bloque %.1f%%\n", 100.0 * hits / sample_count);
+
+    static classifier_model_t quantized;
+    quantize_model(mean, std, &quantized);
+    printf("Modelo int8:\n");
+    evaluate(&quantized, label_map);
+    return write_header(argv[3], argv[2], &quantized);
+}
@@ -0,0 +1,219 @@
+/**
+ * @file fmt_bench.c
+ * @brief Herramienta que compara snprintf con "%f" y el formateo entero de fmt.h
+ *
+ * Mide las tres salidas que pasaron de printf a fmt, con el código anterior
+ * copiado tal cual:
+ *  - registro de medición: "Noise: %u, Lat: %f, Lon: %f" a partir de las
+ *    coordenadas NMEA (convert_to_decimal() en double contra
+ *    fmt_nmea_to_e6() y fmt_fixed());
+ *  - URL de Google Maps: snprintf contra fmt_maps_url();
+ *  - nivel en dB: 20 * log10() en float y "%f" contra kernel_power_cdb() y
+ *    fmt_fixed() con 2 decimales, como lo escribe ahora Micro_completo.c.
+ * Para las dos primeras también comprueba que el texto sea idéntico salvo en
+ * los empates exactos del sexto decimal, que fmt_nmea_to_e6() redondea hacia
+ * arriba y el double de "%f" hacia cualquier lado. El mismo
+ * archivo compila para la Pico (PICO_ON_DEVICE), donde el float es emulado y
+ * la diferencia es mayor.
+ *
+ * El tamaño en flash no se puede medir desde el programa: se compara
+ * arm-none-eabi-size del firmware con PICO_PRINTF_SUPPORT_FLOAT en 1 y en 0
+ * (ya nada del firmware usa "%f").
+ *
+ * Compilación: gcc -O2 -I../Librerias fmt_bench.c ../Librerias/fmt.c ../Librerias/kernels.c -lm -o fmt_bench
+ * En la Pico: un ejecutable con fmt_bench.c, fmt.c, kernels.c y pico_stdlib.
+ * Uso: fmt_bench
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "fmt.h"
+#include "kernels.h"
+#ifdef PICO_ON_DEVICE
+#include "pico/stdlib.h"
+#define CASES 256          ///< Entradas distintas por prueba
+#define ROUNDS 20          ///< Pasadas sobre las entradas
+#else
+#define CASES 4096
+#define ROUNDS 200
+#endif
+
+#define NOISE_REF_CDB 6708 ///< 20 * log10(2260 uV) en centésimas de dB, como en Micro_completo.c
+
+static char nmea_lat[CASES][16], nmea_lon[CASES][16];
+static char lat_dir[CASES], lon_dir[CASES];
+static uint32_t noise_uv[CASES];
+static volatile size_t sink;
+
+static uint64_t now_ns(void) {
+#ifdef PICO_ON_DEVICE
+    return time_us_64() * 1000;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief convert_to_decimal() de gps.c antes de fmt
+ */
+static double convert_to_decimal(const char *coord, char direction) {
+    double degrees = 0;
+    double minutes = 0;
+    if (direction == 'N' || direction == 'S') {
+        degrees = (coord[0] - '0') * 10 + (coord[1] - '0');
+        minutes = atof(coord + 2);
+    } else {
+        degrees = (coord[0] - '0') * 100 + (coord[1] - '0') * 10 + (coord[2] - '0');
+        minutes = atof(coord + 3);
+    }
+    double decimal = degrees + (minutes / 60.0);
+    if (direction == 'S' || direction == 'W') {
+        decimal = -decimal;
+    }
+    return decimal;
+}
+
+/**
+ * @brief Indica si la coordenada en micro-grados termina exactamente en medio
+ *
+ * Los minutos con 5 decimales son m / 10^5, que en micro-grados es m / 6:
+ * hay empate cuando m % 6 == 3.
+ */
+static bool exact_tie(const char *coord, char direction) {
+    const char *p = coord + (direction == 'N' || direction == 'S' ? 2 : 3);
+    uint32_t m = 0;
+    int frac_digits = -1;
+    for (; *p; p++) {
+        if (*p == '.') {
+            frac_digits = 0;
+            continue;
+        }
+        m = m * 10 + (uint32_t)(*p - '0');
+        if (frac_digits >= 0) {
+            frac_digits++;
+        }
+    }
+    while (frac_digits++ < 5) {
+        m *= 10;
+    }
+    return m % 6 == 3;
+}
+
+static size_t record_printf(char *buf, size_t size, int i) {
+    double latitude = convert_to_decimal(nmea_lat[i], lat_dir[i]);
+    double longitude = convert_to_decimal(nmea_lon[i], lon_dir[i]);
+    return (size_t)snprintf(buf, size, "Noise: %u, Lat: %f, Lon: %f\n", (unsigned)noise_uv[i], latitude, longitude);
+}
+
+static size_t record_fmt(char *buf, int i) {
+    char *p = buf;
+    p += fmt_str(p, "Noise: ");
+    p += fmt_uint(p, noise_uv[i]);
+    p += fmt_str(p, ", Lat: ");
+    p += fmt_fixed(p, fmt_nmea_to_e6(nmea_lat[i], lat_dir[i]), 6, 6);
+    p += fmt_str(p, ", Lon: ");
+    p += fmt_fixed(p, fmt_nmea_to_e6(nmea_lon[i], lon_dir[i]), 6, 6);
+    p += fmt_str(p, "\n");
+    return (size_t)(p - buf);
+}
+
+static size_t url_printf(char *buf, size_t size, int i) {
+    double latitude = convert_to_decimal(nmea_lat[i], lat_dir[i]);
+    double longitude = convert_to_decimal(nmea_lon[i], lon_dir[i]);
+    return (size_t)snprintf(buf, size, "https://www.google.com/maps?q=%f,%f", latitude, longitude);
+}
+
+static size_t url_fmt(char *buf, int i) {
+    return fmt_maps_url(buf, fmt_nmea_to_e6(nmea_lat[i], lat_dir[i]), fmt_nmea_to_e6(nmea_lon[i], lon_dir[i]));
+}
+
+static size_t db_printf(char *buf, size_t size, int i) {
+    float noise = noise_uv[i] / 1e6f;
+    float avg_noise_db = 20 * log10f(noise / 0.00226f);
+    return (size_t)snprintf(buf, size, "%f", avg_noise_db);
+}
+
+static size_t db_fmt(char *buf, int i) {
+    int32_t cdb = kernel_power_cdb((uint64_t)noise_uv[i] * noise_uv[i]) - NOISE_REF_CDB;
+    return fmt_fixed(buf, cdb, 2, 2);
+}
+
+/**
+ * @brief Nanosegundos por llamada de una versión
+ */
+#define TIME_CALLS(result, call)                            \
+    do {                                                    \
+        char out[96];                                       \
+        uint64_t t0 = now_ns();                             \
+        for (int r = 0; r < ROUNDS; r++) {                  \
+            for (int i = 0; i < CASES; i++) {               \
+                sink += (call);                             \
+            }                                               \
+        }                                                   \
+        (result) = (double)(now_ns() - t0) / ((double)ROUNDS * CASES); \
+    } while (0)
+
+static void print_row(const char *name, double printf_ns, double fmt_ns, int mismatches, int ties) {
+    printf("%-16s %10.0f ns %10.0f ns %8.1fx  ", name, printf_ns, fmt_ns, printf_ns / fmt_ns);
+    if (mismatches < 0) {
+        printf("-\n");
+    } else {
+        printf("%d distintos, %d empates\n", mismatches, ties);
+    }
+}
+
+int main(void) {
+#ifdef PICO_ON_DEVICE
+    stdio_init_all();
+    sleep_ms(2000); // Tiempo para abrir la consola USB
+#endif
+    srand(1);
+    for (int i = 0; i < CASES; i++) {
+        // Coordenadas NMEA con 4 o 5 decimales de minuto, en los cuatro hemisferios
+        int decimals = 4 + (i & 1);
+        uint32_t frac = (uint32_t)rand() % (decimals == 4 ? 10000 : 100000);
+        snprintf(nmea_lat[i], sizeof(nmea_lat[i]), "%02d%02d.%0*u", rand() % 90, rand() % 60, decimals, (unsigned)frac);
+        snprintf(nmea_lon[i], sizeof(nmea_lon[i]), "%03d%02d.%0*u", rand() % 180, rand() % 60, decimals, (unsigned)frac);
+        lat_dir[i] = rand() & 1 ? 'N' : 'S';
+        lon_dir[i] = rand() & 1 ? 'E' : 'W';
+        noise_uv[i] = 2000 + (uint32_t)rand() % 1600000;
+    }
+
+    int record_diff = 0, url_diff = 0, record_ties = 0, url_ties = 0;
+    for (int i = 0; i < CASES; i++) {
+        char a[96], b[96];
+        bool tie = exact_tie(nmea_lat[i], lat_dir[i]) || exact_tie(nmea_lon[i], lon_dir[i]);
+        record_printf(a, sizeof(a), i);
+        record_fmt(b, i);
+        if (strcmp(a, b) != 0) {
+            *(tie ? &record_ties : &record_diff) += 1;
+        }
+        url_printf(a, sizeof(a), i);
+        url_fmt(b, i);
+        if (strcmp(a, b) != 0) {
+            *(tie ? &url_ties : &url_diff) += 1;
+        }
+    }
+
+    double printf_ns, fmt_ns;
+    printf("%-16s %13s %13s %9s  %s\n", "Salida", "snprintf %f", "fmt", "Mejora", "Texto");
+    TIME_CALLS(printf_ns, record_printf(out, sizeof(out), i));
+    TIME_CALLS(fmt_ns, record_fmt(out, i));
+    print_row("Registro", printf_ns, fmt_ns, record_diff, record_ties);
+    TIME_CALLS(printf_ns, url_printf(out, sizeof(out), i));
+    TIME_CALLS(fmt_ns, url_fmt(out, i));
+    print_row("URL de Maps", printf_ns, fmt_ns, url_diff, url_ties);
+    TIME_CALLS(printf_ns, db_printf(out, sizeof(out), i));
+    TIME_CALLS(fmt_ns, db_fmt(out, i));
+    print_row("Nivel en dB", printf_ns, fmt_ns, -1, 0);
+    printf("Casos: %d; el nivel en dB se escribe con 2 decimales (resolución de centésimas) en lugar de 6\n", CASES);
+    return record_diff || url_diff;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file geofence_bench.c
+ * @brief Herramienta de PC que mide geofence_lookup() contra una búsqueda lineal
+ *
+ * Arma zonas sintéticas (polígonos estrellados de BENCH_VERTICES vértices
+ * sobre un área como la de una ciudad), las empaqueta con el mismo código de
+ * geofence_pack.c y mide geofence_lookup() en consultas por segundo para cada
+ * número de polígonos. La referencia es una búsqueda lineal en double sobre
+ * todas las zonas, sin rejilla, que se mide sola; después se comparan las dos
+ * respuestas fuera de la medición. También comprueba que geofence_init()
+ * rechace un índice de celdas que retrocede.
+ *
+ * Compilación: gcc -O2 -I../Librerias geofence_bench.c ../Librerias/fmt.c ../Librerias/geofence.c -lm -o geofence_bench
+ * Uso: geofence_bench
+ */
+
+#define _DEFAULT_SOURCE
+#include <time.h>
+#define GEOFENCE_PACK_NO_MAIN
+#include "geofence_pack.c"
+
+#define BENCH_VERTICES 12       ///< Vértices de cada polígono sintético
+#define BENCH_AREA_E6 200000    ///< Lado del área de las zonas sintéticas (~22 km)
+#define BENCH_LOOKUPS 1000000   ///< Consultas medidas con la rejilla
+#define BENCH_CHECKS 20000      ///< Consultas medidas con la búsqueda lineal y comparadas
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Punto en polígono en double, sin rejilla, como referencia
+ */
+static bool float_contains(const geofence_zone_t *zone, double lat, double lon) {
+    const int32_t *v = vertices + 2 * zone->first_vertex;
+    uint32_t n = zone->vertex_count;
+    bool inside = false;
+    for (uint32_t i = 0, j = n - 1; i < n; j = i++) {
+        double lat_i = v[2 * i] / 1e6, lon_i = v[2 * i + 1] / 1e6;
+        double lat_j = v[2 * j] / 1e6, lon_j = v[2 * j + 1] / 1e6;
+        if ((lat_i > lat) != (lat_j > lat) && lon < lon_i + (lon_j - lon_i) * (lat - lat_i) / (lat_j - lat_i)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+static uint16_t float_lookup(int32_t lat_e6, int32_t lon_e6) {
+    for (uint32_t i = 0; i < header.zone_count; i++) {
+        if (float_contains(&zones[i], lat_e6 / 1e6, lon_e6 / 1e6)) {
+            return zones[i].id;
+        }
+    }
+    return GEOFENCE_NO_ZONE;
+}
+
+static int32_t random_coord(int32_t origin, int32_t span) {
+    return origin + (int32_t)(((uint32_t)rand() << 16 ^ (uint32_t)rand()) % (uint32_t)span);
+}
+
+int main(void) {
+    static const uint32_t counts[] = { 10, 100, 1000, 5000 };
+    static uint16_t linear_ids[BENCH_CHECKS];
+    const int32_t origin_lat = 6150000, origin_lon = -75650000; // Alrededor de Medellín
+    int32_t *points = malloc(2 * BENCH_LOOKUPS * sizeof(int32_t));
+    int mismatches_total = 0;
+
+    printf("%-9s %-9s %10s %14s %14s %10s\n", "Zonas", "Rejilla", "Bytes", "Con rejilla/s", "Lineal/s", "Distintos");
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        srand(1);
+        header.zone_count = 0;
+        header.vertex_count = 0;
+        for (uint32_t z = 0; z < counts[c]; z++) {
+            int32_t lat = random_coord(origin_lat, BENCH_AREA_E6);
+            int32_t lon = random_coord(origin_lon, BENCH_AREA_E6);
+            double radius = 1000 + rand() % 6000; // ~110 m a ~780 m
+            add_zone((uint16_t)(z + 1), 6500, 5500);
+            for (int k = 0; k < BENCH_VERTICES; k++) {
+                double r = radius * (k & 1 ? 0.5 + (rand() % 50) / 100.0 : 1.0);
+                double a = 2.0 * M_PI * k / BENCH_VERTICES;
+                add_vertex(lat + (int32_t)lround(r * sin(a)), lon + (int32_t)lround(r * cos(a)));
+            }
+        }
+        size_t words;
+        uint32_t *data = pack_zones(0, &words);
+        if (!geofence_init(data, words)) {
+            fprintf(stderr, "geofence_init rechazó los datos de %u zonas\n", counts[c]);
+            free(data);
+            free(points);
+            return 1;
+        }
+
+        for (uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+            points[2 * i] = random_coord(origin_lat, BENCH_AREA_E6);
+            points[2 * i + 1] = random_coord(origin_lon, BENCH_AREA_E6);
+        }
+        volatile uint32_t found = 0;
+        uint64_t t0 = now_ns();
+        for (uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+            found += geofence_lookup(points[2 * i], points[2 * i + 1]) != NULL;
+        }
+        double grid_rate = BENCH_LOOKUPS / ((now_ns() - t0) / 1e9);
+
+        t0 = now_ns();
+        for (uint32_t i = 0; i < BENCH_CHECKS; i++) {
+            linear_ids[i] = float_lookup(points[2 * i], points[2 * i + 1]);
+        }
+        double linear_rate = BENCH_CHECKS / ((now_ns() - t0) / 1e9);
+
+        int mismatches = 0;
+        for (uint32_t i = 0; i < BENCH_CHECKS; i++) {
+            const geofence_zone_t *zone = geofence_lookup(points[2 * i], points[2 * i + 1]);
+            mismatches += linear_ids[i] != (zone ? zone->id : GEOFENCE_NO_ZONE);
+        }
+        mismatches_total += mismatches;
+
+        char grid[16];
+        snprintf(grid, sizeof(grid), "%ux%u", header.cols, header.rows);
+        printf("%-9u %-9s %10zu %14.0f %14.0f %10d\n", counts[c], grid, words * 4, grid_rate, linear_rate, mismatches);
+
+        // Un índice de celdas que retrocede debe rechazarse en geofence_init()
+        uint32_t *start = data + sizeof(header) / 4 + header.zone_count * sizeof(geofence_zone_t) / 4 + header.vertex_count * 2;
+        uint32_t saved = start[1];
+        start[1] = start[2] + 1;
+        if (geofence_init(data, words)) {
+            fprintf(stderr, "geofence_init aceptó un cell_start decreciente con %u zonas\n", counts[c]);
+            mismatches_total++;
+        }
+        start[1] = saved;
+        free(data);
+    }
+    printf("Polígonos de %d vértices en %.2f x %.2f grados; consultas en todo el área.\n"
+        "Distintos = consultas (de %d) en que la rejilla no coincide con la búsqueda lineal en double.\n",
+        BENCH_VERTICES, BENCH_AREA_E6 / 1e6, BENCH_AREA_E6 / 1e6, BENCH_CHECKS);
+    free(points);
+    return mismatches_total != 0;
+}
@@ -0,0 +1,270 @@
+/**
+ * @file geofence_pack.c
+ * @brief Herramienta de PC que convierte un archivo de zonas al formato de geofence.h
+ *
+ * El archivo de entrada es texto, una orden por línea ('#' inicia un comentario):
+ *
+ *   utc_offset -300          Hora local menos UTC, en minutos
+ *   day 07:00                Inicio del horario diurno (hora local)
+ *   night 21:00              Inicio del horario nocturno (hora local)
+ *   zone 1 65 55             Nueva zona: identificador, límite diurno y nocturno en dB
+ *   6.2001 -75.5702          Vértice de la zona actual: latitud y longitud en grados
+ *
+ * Si varias zonas se solapan gana la que aparece primero. La salida es una
+ * cabecera C con el arreglo geofence_data[] listo para geofence_init().
+ * Con GEOFENCE_PACK_NO_MAIN quedan fuera la lectura del archivo y main();
+ * así lo incluye geofence_bench.c para empaquetar sus zonas sintéticas con
+ * el mismo código.
+ *
+ * Compilación: gcc -O2 -I../Librerias geofence_pack.c ../Librerias/fmt.c ../Librerias/geofence.c -lm -o geofence_pack
+ * Uso: geofence_pack zonas.txt geofence_data.h [lado_celda_micro_grados]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "geofence.h"
+#include "fmt.h"
+
+#define MAX_CELLS 65536 ///< Celdas máximas de la rejilla
+
+static geofence_header_t header = { GEOFENCE_MAGIC, GEOFENCE_VERSION, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7 * 60, 21 * 60, 0 };
+static geofence_zone_t *zones;
+static int32_t *vertices;
+static size_t zone_capacity;
+static size_t vertex_capacity;
+
+static void add_zone(uint16_t id, int32_t day_cdb, int32_t night_cdb) {
+    if (header.zone_count == zone_capacity) {
+        zone_capacity = zone_capacity ? zone_capacity * 2 : 64;
+        zones = realloc(zones, zone_capacity * sizeof(*zones));
+    }
+    geofence_zone_t *zone = &zones[header.zone_count++];
+    memset(zone, 0, sizeof(*zone));
+    zone->id = id;
+    zone->limit_day_cdb = (int16_t)day_cdb;
+    zone->limit_night_cdb = (int16_t)night_cdb;
+    zone->first_vertex = header.vertex_count;
+}
+
+static void add_vertex(int32_t lat, int32_t lon) {
+    if (header.vertex_count == vertex_capacity) {
+        vertex_capacity = vertex_capacity ? vertex_capacity * 2 : 1024;
+        vertices = realloc(vertices, vertex_capacity * 2 * sizeof(*vertices));
+    }
+    vertices[2 * header.vertex_count] = lat;
+    vertices[2 * header.vertex_count + 1] = lon;
+    header.vertex_count++;
+
+    geofence_zone_t *zone = &zones[header.zone_count - 1];
+    if (zone->vertex_count == 0 || lat < zone->min_lat) zone->min_lat = lat;
+    if (zone->vertex_count == 0 || lat > zone->max_lat) zone->max_lat = lat;
+    if (zone->vertex_count == 0 || lon < zone->min_lon) zone->min_lon = lon;
+    if (zone->vertex_count == 0 || lon > zone->max_lon) zone->max_lon = lon;
+    zone->vertex_count++;
+}
+
+/**
+ * @brief Elige la rejilla: unas dos celdas por zona sobre el rectángulo de todas
+ */
+static void choose_grid(int64_t cell_size) {
+    int32_t min_lat = zones[0].min_lat, max_lat = zones[0].max_lat;
+    int32_t min_lon = zones[0].min_lon, max_lon = zones[0].max_lon;
+    for (uint32_t i = 1; i < header.zone_count; i++) {
+        if (zones[i].min_lat < min_lat) min_lat = zones[i].min_lat;
+        if (zones[i].max_lat > max_lat) max_lat = zones[i].max_lat;
+        if (zones[i].min_lon < min_lon) min_lon = zones[i].min_lon;
+        if (zones[i].max_lon > max_lon) max_lon = zones[i].max_lon;
+    }
+    int64_t span_lat = (int64_t)max_lat - min_lat + 1;
+    int64_t span_lon = (int64_t)max_lon - min_lon + 1;
+
+    if (cell_size <= 0) {
+        double target = 2.0 * header.zone_count;
+        cell_size = (int64_t)ceil(sqrt((double)span_lat * (double)span_lon / target));
+    }
+    if (cell_size < 1) {
+        cell_size = 1;
+    }
+    while ((span_lat + cell_size - 1) / cell_size * ((span_lon + cell_size - 1) / cell_size) > MAX_CELLS) {
+        cell_size += cell_size / 8 + 1;
+    }
+
+    header.origin_lat = min_lat;
+    header.origin_lon = min_lon;
+    header.cell_size = (int32_t)cell_size;
+    header.rows = (uint16_t)((span_lat + cell_size - 1) / cell_size);
+    header.cols = (uint16_t)((span_lon + cell_size - 1) / cell_size);
+}
+
+/**
+ * @brief Celda de un punto, limitada a la rejilla
+ */
+static uint32_t cell_index(int32_t value, int32_t origin, uint16_t count) {
+    int64_t index = ((int64_t)value - origin) / header.cell_size;
+    return index < 0 ? 0 : index >= count ? count - 1u : (uint32_t)index;
+}
+
+/**
+ * @brief Empaqueta las zonas leídas en el formato de geofence.h
+ *
+ * @param cell_size Lado de celda en micro-grados (0 para elegirlo solo)
+ * @param words Tamaño del resultado en palabras
+ * @return Datos para geofence_init() (liberar con free)
+ */
+static uint32_t *pack_zones(int64_t cell_size, size_t *words) {
+    choose_grid(cell_size);
+
+    // Lista de zonas por celda, en orden de archivo para respetar la prioridad
+    uint32_t cells = (uint32_t)header.cols * header.rows;
+    uint32_t *cell_start = calloc(cells + 1, sizeof(uint32_t));
+    for (uint32_t i = 0; i < header.zone_count; i++) {
+        for (uint32_t r = cell_index(zones[i].min_lat, header.origin_lat, header.rows); r <= cell_index(zones[i].max_lat, header.origin_lat, header.rows); r++) {
+            for (uint32_t c = cell_index(zones[i].min_lon, header.origin_lon, header.cols); c <= cell_index(zones[i].max_lon, header.origin_lon, header.cols); c++) {
+                cell_start[r * header.cols + c + 1]++;
+            }
+        }
+    }
+    for (uint32_t k = 0; k < cells; k++) {
+        cell_start[k + 1] += cell_start[k];
+    }
+    header.cell_refs = cell_start[cells];
+    uint16_t *cell_zones = calloc(header.cell_refs + 1, sizeof(uint16_t));
+    uint32_t *fill = malloc(cells * sizeof(uint32_t));
+    memcpy(fill, cell_start, cells * sizeof(uint32_t));
+    for (uint32_t i = 0; i < header.zone_count; i++) {
+        for (uint32_t r = cell_index(zones[i].min_lat, header.origin_lat, header.rows); r <= cell_index(zones[i].max_lat, header.origin_lat, header.rows); r++) {
+            for (uint32_t c = cell_index(zones[i].min_lon, header.origin_lon, header.cols); c <= cell_index(zones[i].max_lon, header.origin_lon, header.cols); c++) {
+                cell_zones[fill[r * header.cols + c]++] = (uint16_t)i;
+            }
+        }
+    }
+
+    *words = sizeof(header) / 4 + header.zone_count * sizeof(geofence_zone_t) / 4 + header.vertex_count * 2 + cells + 1 + (header.cell_refs + 1) / 2;
+    uint32_t *data = calloc(*words, sizeof(uint32_t));
+    uint8_t *p = (uint8_t *)data;
+    memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    memcpy(p, zones, header.zone_count * sizeof(geofence_zone_t));
+    p += header.zone_count * sizeof(geofence_zone_t);
+    memcpy(p, vertices, header.vertex_count * 2 * sizeof(int32_t));
+    p += header.vertex_count * 2 * sizeof(int32_t);
+    memcpy(p, cell_start, (cells + 1) * sizeof(uint32_t));
+    p += (cells + 1) * sizeof(uint32_t);
+    memcpy(p, cell_zones, header.cell_refs * sizeof(uint16_t));
+
+    free(fill);
+    free(cell_zones);
+    free(cell_start);
+    return data;
+}
+
+#ifndef GEOFENCE_PACK_NO_MAIN
+/**
+ * @brief Lee una hora "hh:mm" como minuto del día
+ */
+static uint16_t parse_minute(const char *s) {
+    int hours = 0, minutes = 0;
+    sscanf(s, "%d:%d", &hours, &minutes);
+    return (uint16_t)((hours * 60 + minutes) % 1440);
+}
+
+/**
+ * @brief Lee el archivo de zonas
+ *
+ * @return 0 si todo está bien, 1 si hay un error (ya reportado)
+ */
+static int read_zones(FILE *in, const char *path) {
+    char line[256];
+    int number = 0;
+
+    while (fgets(line, sizeof(line), in)) {
+        number++;
+        char *comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        char a[64], b[64], c[64], d[64];
+        int fields = sscanf(line, "%63s %63s %63s %63s", a, b, c, d);
+        if (fields <= 0) {
+            continue;
+        }
+        if (strcmp(a, "utc_offset") == 0 && fields == 2) {
+            header.utc_offset_min = (int16_t)atoi(b);
+        } else if (strcmp(a, "day") == 0 && fields == 2) {
+            header.day_start_min = parse_minute(b);
+        } else if (strcmp(a, "night") == 0 && fields == 2) {
+            header.night_start_min = parse_minute(b);
+        } else if (strcmp(a, "zone") == 0 && fields == 4) {
+            int id = atoi(b);
+            if (id <= GEOFENCE_NO_ZONE || id > UINT16_MAX) {
+                fprintf(stderr, "%s:%d: identificador de zona inválido\n", path, number);
+                return 1;
+            }
+            add_zone((uint16_t)id, fmt_parse_fixed(c, 2), fmt_parse_fixed(d, 2));
+        } else if (fields == 2 && header.zone_count > 0) {
+            add_vertex(fmt_parse_fixed(a, 6), fmt_parse_fixed(b, 6));
+        } else {
+            fprintf(stderr, "%s:%d: línea no reconocida\n", path, number);
+            return 1;
+        }
+    }
+
+    for (uint32_t i = 0; i < header.zone_count; i++) {
+        if (zones[i].vertex_count < 3) {
+            fprintf(stderr, "%s: la zona %u tiene menos de 3 vértices\n", path, zones[i].id);
+            return 1;
+        }
+    }
+    if (header.zone_count == 0) {
+        fprintf(stderr, "%s: no hay zonas\n", path);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s zonas.txt geofence_data.h [lado_celda_micro_grados]\n", argv[0]);
+        return 1;
+    }
+    FILE *in = fopen(argv[1], "r");
+    if (!in) {
+        perror(argv[1]);
+        return 1;
+    }
+    int error = read_zones(in, argv[1]);
+    fclose(in);
+    if (error) {
+        return 1;
+    }
+    size_t words;
+    uint32_t *data = pack_zones(argc > 3 ? strtoll(argv[3], NULL, 10) : 0, &words);
+
+    FILE *out = fopen(argv[2], "w");
+    if (!out) {
+        perror(argv[2]);
+        free(data);
+        return 1;
+    }
+    fprintf(out, "/**\n * @file geofence_data.h\n * @brief Zonas para geofence_init(), generado por geofence_pack a partir de %s\n */\n\n", argv[1]);
+    fprintf(out, "#ifndef GEOFENCE_DATA_H\n#define GEOFENCE_DATA_H\n\n#include <stdint.h>\n\n");
+    fprintf(out, "#define GEOFENCE_DATA_WORDS %zu ///< %u zonas, %lu vértices, rejilla de %ux%u\n\n",
+        words, header.zone_count, (unsigned long)header.vertex_count, header.cols, header.rows);
+    fprintf(out, "static const uint32_t geofence_data[GEOFENCE_DATA_WORDS] = {");
+    for (size_t i = 0; i < words; i++) {
+        fprintf(out, "%s0x%08lx,", i % 8 ? " " : "\n    ", (unsigned long)data[i]);
+    }
+    fprintf(out, "\n};\n\n#endif // GEOFENCE_DATA_H\n");
+    fclose(out);
+
+    printf("%u zonas, %lu vértices, rejilla de %ux%u celdas de %ld micro-grados, %zu bytes\n",
+        header.zone_count, (unsigned long)header.vertex_count, header.cols, header.rows,
+        (long)header.cell_size, words * 4);
+    free(data);
+    return 0;
+}
+#endif // GEOFENCE_PACK_NO_MAIN
@@ -0,0 +1,166 @@
+/**
+ * @file kernels_bench.c
+ * @brief Herramienta que compara kernel_block_stats() con los bucles por muestra
+ *
+ * Para bloques de 100 muestras (el del modo manual) hasta 2048 muestras
+ * (4 KB) mide tres versiones sobre los mismos datos, con una muestra con
+ * error cada ERROR_EVERY:
+ *  - el bucle original de isrDMA_IRQ0: salto por muestra y suma en float;
+ *  - el bucle entero por muestra que usaba monitor_push_block() antes de los
+ *    núcleos: suma, suma de cuadrados, mínimo, máximo y errores con saltos;
+ *  - kernel_block_stats(), con el bloque alineado y desalineado.
+ * Los resultados del núcleo se comparan con el bucle entero. En x86 se usa la
+ * versión SSE2; compilando con -U__SSE2__ se comprueba la versión SWAR, pero
+ * su tiempo solo es representativo en la placa: en el PC el float es por
+ * hardware y el bucle entero se vectoriza solo. El mismo archivo compila para
+ * la Pico (PICO_ON_DEVICE) e imprime la tabla por stdio.
+ *
+ * Compilación: gcc -O2 -I../Librerias kernels_bench.c ../Librerias/kernels.c -o kernels_bench
+ *              (versión SWAR: agregar -U__SSE2__)
+ * En la Pico: un ejecutable con kernels_bench.c, kernels.c y pico_stdlib.
+ * Uso: kernels_bench
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "kernels.h"
+#ifdef PICO_ON_DEVICE
+#include "pico/stdlib.h"
+#endif
+
+#define ERROR_EVERY 61              ///< Una muestra con error cada tantas
+#define MAX_BLOCK 2048              ///< 4 KB de muestras
+#ifdef PICO_ON_DEVICE
+#define TARGET_SAMPLES 1000000      ///< Muestras procesadas por medición
+#else
+#define TARGET_SAMPLES 20000000
+#endif
+
+static uint64_t now_ns(void) {
+#ifdef PICO_ON_DEVICE
+    return time_us_64() * 1000;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Bucle de isrDMA_IRQ0 antes de los núcleos
+ */
+static __attribute__((noinline)) float float_loop(const uint16_t *block, uint16_t count) {
+    uint16_t cnt = 0;
+    float noise = 0;
+    for (int i = 0; i < count; i++) {
+        if (!(block[i] & (1 << 15))) {
+            cnt++;
+            noise += (float)block[i];
+        }
+    }
+    return noise / cnt;
+}
+
+/**
+ * @brief Bucle entero por muestra con saltos, con las mismas salidas que el núcleo
+ */
+static __attribute__((noinline)) void int_loop(const uint16_t *block, uint16_t count, block_stats_t *stats) {
+    uint32_t sum = 0;
+    uint64_t sum_sq = 0;
+    uint16_t min = 0x0FFF, max = 0, valid = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t sample = block[i];
+        if (!(sample & (1 << 15))) {
+            sample &= 0x0FFF;
+            sum += sample;
+            sum_sq += (uint32_t)sample * sample;
+            if (sample < min) min = sample;
+            if (sample > max) max = sample;
+            valid++;
+        }
+    }
+    stats->sum = sum;
+    stats->sum_sq = sum_sq;
+    stats->min = min;
+    stats->max = max;
+    stats->valid = valid;
+    stats->errors = count - valid;
+}
+
+static bool same_stats(const block_stats_t *a, const block_stats_t *b) {
+    return a->sum == b->sum && a->sum_sq == b->sum_sq && a->min == b->min && a->max == b->max &&
+        a->valid == b->valid && a->errors == b->errors;
+}
+
+/**
+ * @brief Nanosegundos por bloque de una versión
+ */
+#define TIME_BLOCKS(result, rounds, call)                   \
+    do {                                                    \
+        uint64_t t0 = now_ns();                             \
+        for (uint32_t r = 0; r < (rounds); r++) {           \
+            call;                                           \
+            __asm__ volatile("" ::: "memory");              \
+        }                                                   \
+        (result) = (double)(now_ns() - t0) / (rounds);      \
+    } while (0)
+
+int main(void) {
+    static const uint16_t sizes[] = { 100, 256, 512, 1024, 2048 };
+    // Una muestra de más para poder empezar en una dirección desalineada
+    static uint16_t buffer[MAX_BLOCK + 2] __attribute__((aligned(16)));
+    volatile float float_sink;
+    block_stats_t ref, out;
+    bool all_ok = true;
+
+#ifdef PICO_ON_DEVICE
+    stdio_init_all();
+    sleep_ms(2000); // Tiempo para abrir la consola USB
+#endif
+    srand(1);
+    for (size_t i = 0; i < MAX_BLOCK + 2; i++) {
+        buffer[i] = (uint16_t)(1548 + rand() % 1000);
+        if (i % ERROR_EVERY == 7) {
+            buffer[i] |= 1 << 15;
+        }
+    }
+
+#if defined(__SSE2__)
+    const char *kernel_name = "SSE2";
+#else
+    const char *kernel_name = "SWAR";
+#endif
+    printf("Núcleo: %s\n", kernel_name);
+    printf("%-8s %12s %12s %12s %12s %9s %9s  %s\n", "Muestras", "float", "entero", "núcleo",
+        "desalineado", "vs float", "vs entero", "Resultado");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint16_t count = sizes[s];
+        uint32_t rounds = TARGET_SAMPLES / count;
+        double float_ns, int_ns, kernel_ns, unaligned_ns;
+
+        int_loop(buffer, count, &ref);
+        kernel_block_stats(buffer, count, &out);
+        bool ok = same_stats(&ref, &out);
+        int_loop(buffer + 1, count, &ref);
+        kernel_block_stats(buffer + 1, count, &out);
+        ok = ok && same_stats(&ref, &out);
+        all_ok = all_ok && ok;
+
+        TIME_BLOCKS(float_ns, rounds, float_sink = float_loop(buffer, count));
+        TIME_BLOCKS(int_ns, rounds, int_loop(buffer, count, &ref));
+        TIME_BLOCKS(kernel_ns, rounds, kernel_block_stats(buffer, count, &out));
+        TIME_BLOCKS(unaligned_ns, rounds, kernel_block_stats(buffer + 1, count, &out));
+
+        printf("%-8u %9.1f ns %9.1f ns %9.1f ns %9.1f ns %8.2fx %8.2fx  %s\n", count, float_ns, int_ns,
+            kernel_ns, unaligned_ns, float_ns / kernel_ns, int_ns / kernel_ns, ok ? "igual" : "DISTINTO");
+    }
+    (void)float_sink;
+    return all_ok ? 0 : 1;
+}
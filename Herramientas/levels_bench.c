@@ -0,0 +1,189 @@
+/**
+ * @file levels_bench.c
+ * @brief Herramienta que comprueba la memoria constante y la exactitud de levels.h
+ *
+ * Arma series de niveles cortos de ~128 ms (fondo que varía lento más
+ * pasadas de vehículos y golpes) de 1 minuto, 1 hora y 24 horas. Cada serie se
+ * cuenta en dos resúmenes que luego se combinan, como hace el monitor con
+ * el intervalo de cada evento y el total, y se compara L10/L50/L90 con el
+ * método del rango más cercano sobre la serie ordenada. Para cada duración
+ * informa:
+ *  - la memoria del resumen contra la de guardar todos los niveles;
+ *  - el tiempo de levels_add() por nivel, de levels_merge() y de las tres
+ *    consultas, que no deben crecer con la duración;
+ *  - el tiempo de ordenar la serie, que sí crece;
+ *  - el peor error contra el orden exacto, que debe ser a lo sumo media
+ *    casilla (LEVELS_BIN_CDB / 2).
+ * El mismo archivo compila para la Pico (PICO_ON_DEVICE) sin la serie de
+ * 24 horas, que no cabe en la RAM.
+ *
+ * Compilación: gcc -O2 -I../Librerias levels_bench.c ../Librerias/levels.c -o levels_bench
+ * En la Pico: un ejecutable con levels_bench.c, levels.c y pico_stdlib.
+ * Uso: levels_bench
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "levels.h"
+#ifdef PICO_ON_DEVICE
+#include "pico/stdlib.h"
+#define TRIALS 4               ///< Series distintas por duración
+#else
+#define TRIALS 20
+#endif
+
+#define LEVELS_PER_HOUR 28125  ///< Niveles cortos de 128 ms en una hora
+#define QUERY_ROUNDS 2000      ///< Repeticiones de la combinación y las consultas
+
+static const uint8_t percents[] = { 10, 50, 90 };
+
+static uint64_t now_ns(void) {
+#ifdef PICO_ON_DEVICE
+    return time_us_64() * 1000;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static int compare_i32(const void *a, const void *b) {
+    int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Nivel superado el porcentaje del tiempo, por rango más cercano
+ *
+ * @param sorted Niveles en orden ascendente
+ */
+static int32_t exact_exceeded(const int32_t *sorted, uint32_t n, uint8_t percent) {
+    uint32_t above = (uint32_t)((uint64_t)n * percent / 100);
+    return sorted[above >= n ? 0 : n - 1 - above];
+}
+
+/**
+ * @brief Serie sintética en centésimas de dB
+ *
+ * Fondo de 45 a 65 dB que deriva lento, pasadas de vehículos que suben hasta
+ * 20 dB y bajan en unos segundos, y algún golpe aislado.
+ */
+static void make_series(int32_t *levels, uint32_t n) {
+    int32_t base = 4500 + rand() % 2000;
+    int32_t drift = 0, pass = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        drift = drift * 127 / 128 + rand() % 81 - 40;
+        if (rand() % 400 == 0) {
+            pass = 500 + rand() % 1500;
+        }
+        pass = pass * 15 / 16;
+        int32_t hit = rand() % 2000 == 0 ? 1000 + rand() % 2500 : 0;
+        levels[i] = base + drift + pass + hit;
+    }
+}
+
+int main(void) {
+    static const struct {
+        const char *name;
+        uint32_t count;
+    } periods[] = {
+        { "1 min", LEVELS_PER_HOUR / 60 },
+        { "1 h", LEVELS_PER_HOUR },
+#ifndef PICO_ON_DEVICE
+        { "24 h", LEVELS_PER_HOUR * 24 },
+#endif
+    };
+    static levels_t first, second, total;
+    volatile int32_t sink = 0;
+    bool all_ok = true;
+
+#ifdef PICO_ON_DEVICE
+    stdio_init_all();
+    sleep_ms(2000); // Tiempo para abrir la consola USB
+#endif
+    srand(1);
+    uint32_t max_count = periods[sizeof(periods) / sizeof(periods[0]) - 1].count;
+    int32_t *series = malloc(max_count * sizeof(int32_t));
+    int32_t *sorted = malloc(max_count * sizeof(int32_t));
+    if (!series || !sorted) {
+        fprintf(stderr, "Sin memoria para %lu niveles\n", (unsigned long)max_count);
+        return 1;
+    }
+
+    printf("%-6s %8s %9s %11s %9s %10s %10s %12s %10s\n", "Lapso", "Niveles", "Resumen", "Todos",
+        "Agregar", "Combinar", "Consultas", "Ordenar", "Peor err");
+    for (size_t d = 0; d < sizeof(periods) / sizeof(periods[0]); d++) {
+        uint32_t n = periods[d].count;
+        uint64_t add_ns = 0, sort_ns = 0;
+        int32_t worst = 0;
+
+        for (int trial = 0; trial < TRIALS; trial++) {
+            make_series(series, n);
+
+            levels_init(&first);
+            levels_init(&second);
+            uint64_t t0 = now_ns();
+            for (uint32_t i = 0; i < n / 2; i++) {
+                levels_add(&first, series[i]);
+            }
+            for (uint32_t i = n / 2; i < n; i++) {
+                levels_add(&second, series[i]);
+            }
+            add_ns += now_ns() - t0;
+            levels_init(&total);
+            levels_merge(&total, &first);
+            levels_merge(&total, &second);
+
+            memcpy(sorted, series, n * sizeof(int32_t));
+            t0 = now_ns();
+            qsort(sorted, n, sizeof(int32_t), compare_i32);
+            sort_ns += now_ns() - t0;
+
+            for (size_t k = 0; k < sizeof(percents); k++) {
+                int32_t error = levels_exceeded(&total, percents[k]) - exact_exceeded(sorted, n, percents[k]);
+                if (error < 0) {
+                    error = -error;
+                }
+                if (error > worst) {
+                    worst = error;
+                }
+            }
+        }
+
+        // Combinar y consultar no depende de cuántos niveles hay en el resumen
+        uint64_t t0 = now_ns();
+        for (int r = 0; r < QUERY_ROUNDS; r++) {
+            levels_init(&total);
+            levels_merge(&total, &first);
+            __asm__ volatile("" ::: "memory");
+        }
+        double merge_ns = (double)(now_ns() - t0) / QUERY_ROUNDS;
+        t0 = now_ns();
+        for (int r = 0; r < QUERY_ROUNDS; r++) {
+            for (size_t k = 0; k < sizeof(percents); k++) {
+                sink += levels_exceeded(&total, percents[k]);
+            }
+            __asm__ volatile("" ::: "memory");
+        }
+        double query_ns = (double)(now_ns() - t0) / QUERY_ROUNDS;
+
+        bool ok = worst <= LEVELS_BIN_CDB / 2;
+        all_ok = all_ok && ok;
+        printf("%-6s %8lu %7zu B %9lu B %6.2f ns %7.2f us %7.2f us %9.2f ms %5ld cdB%s\n", periods[d].name,
+            (unsigned long)n, sizeof(levels_t), (unsigned long)(n * sizeof(int32_t)),
+            (double)add_ns / ((double)TRIALS * n), merge_ns / 1000, query_ns / 1000,
+            (double)sort_ns / TRIALS / 1e6, (long)worst, ok ? "" : " FUERA");
+    }
+    printf("Resumen = sizeof(levels_t); Todos = guardar cada nivel para ordenar. Combinar incluye levels_init().\n");
+    printf("Consultas = L10, L50 y L90 juntos. Peor error sobre %d series por lapso (límite %d cdB).\n",
+        TRIALS, LEVELS_BIN_CDB / 2);
+    (void)sink;
+    free(series);
+    free(sorted);
+    return all_ok ? 0 : 1;
+}
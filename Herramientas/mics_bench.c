@@ -0,0 +1,181 @@
+/**
+ * @file mics_bench.c
+ * @brief Herramienta de PC que mide el camino round-robin de varios micrófonos
+ *
+ * Arma bloques intercalados como los que escribe el DMA con 1 a
+ * ADC_MAX_CHANNELS canales (un tono distinto por canal y algunas muestras con
+ * el bit de error) y los pasa por mics_push_interleaved(), que separa,
+ * calibra, mezcla y entrega al monitor. Es el trabajo que se hace dentro de la
+ * interrupción del DMA, así que se compara el tiempo por bloque con el
+ * período del bloque: a la frecuencia del modo continuo y a la máxima que
+ * permite ADC_MAX_SAMPLE_RATE con ese número de canales. Si un bloque tarda
+ * más que su período el DMA pisa el buffer que se está procesando. El uso se
+ * calcula con el percentil 99.9 del tiempo por bloque, porque el máximo en el
+ * PC lo dominan las interrupciones del sistema operativo. En x86 también se
+ * cuentan ciclos con el TSC.
+ *
+ * Compilación (SDK de Pico con PICO_PLATFORM=host, como replay.c):
+ *   gcc -O2 -I../Librerias mics_bench.c ../Librerias/mics.c ../Librerias/monitor.c
+ *       ../Librerias/adpcm.c ../Librerias/trace.c ../Librerias/kernels.c
+ *       ../Librerias/fmt.c ../Librerias/geofence.c ../Librerias/classifier.c
+ *       ../Librerias/audio_features.c ../Librerias/levels.c -lm -o mics_bench
+ *
+ * Uso: mics_bench [bloques]
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "mics.h"
+#include "monitor.h"
+#include "memory.h"
+#include "adc.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#define DEFAULT_BLOCKS 4000   ///< Bloques medidos por configuración (~64 s a 16 kHz)
+#define ERROR_EVERY 997       ///< Una muestra con error cada tantas
+#define PERCENTILE 99.9       ///< Percentil del tiempo por bloque que se compara con el período
+#define SIGNAL_BLOCKS 64      ///< Bloques distintos que se arman antes de medir
+
+/**
+ * @brief Versión para PC del módulo de memoria: los eventos se descartan
+ */
+void memory_init(void) {
+}
+
+void memory_write_bytes(const uint8_t *data, size_t length) {
+    (void)data;
+    (void)length;
+}
+
+void memory_write(const char *data) {
+    (void)data;
+}
+
+/**
+ * @brief Versión para PC de la captura del ADC: los bloques los arma la herramienta
+ */
+void adc_dma_start(uint32_t fsample, adc_block_callback_t callback) {
+    (void)fsample;
+    (void)callback;
+}
+
+void adc_dma_start_channels(uint32_t fsample, uint8_t channels, adc_block_callback_t callback) {
+    (void)fsample;
+    (void)channels;
+    (void)callback;
+}
+
+void adc_dma_stop(void) {
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Llena un bloque intercalado; cada canal lleva un tono y un offset propios
+ */
+static void fill_block(uint16_t *block, uint8_t channels, uint32_t first_sample) {
+    static const double tone_hz[ADC_MAX_CHANNELS] = { 500.0, 1000.0, 2000.0 };
+    static const double amplitude[ADC_MAX_CHANNELS] = { 0.30, 0.20, 0.10 };
+    static const int offset[ADC_MAX_CHANNELS] = { 2048, 2010, 2090 };
+
+    for (uint16_t i = 0; i < ADC_BLOCK_SAMPLES; i++) {
+        uint32_t n = first_sample + i;
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            long v = lround(offset[ch] + 2047.0 * amplitude[ch] *
+                sin(2.0 * M_PI * tone_hz[ch] * n / MONITOR_SAMPLE_RATE));
+            uint16_t sample = (uint16_t)(v < 0 ? 0 : v > 4095 ? 4095 : v);
+            if ((n * channels + ch) % ERROR_EVERY == 0) {
+                sample |= 1 << 15;
+            }
+            block[i * channels + ch] = sample;
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t blocks = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : DEFAULT_BLOCKS;
+    if (blocks == 0) {
+        blocks = DEFAULT_BLOCKS;
+    }
+    // Los bloques se arman antes de medir para no contar el seno
+    static uint16_t signal[SIGNAL_BLOCKS][ADC_BLOCK_SAMPLES * ADC_MAX_CHANNELS];
+    uint64_t *times = malloc(blocks * sizeof(uint64_t));
+
+    printf("%-8s %11s %11s %10s", "Canales", "Prom/bloque", "P99.9", "Por canal");
+#ifdef HAVE_TSC
+    printf(" %14s", "Ciclos/muestra");
+#endif
+    printf("  %-24s %s\n", "Período a 16 kHz (uso)", "Período a la tasa máxima (uso)");
+
+    for (uint8_t channels = 1; channels <= ADC_MAX_CHANNELS; channels++) {
+        for (uint32_t b = 0; b < SIGNAL_BLOCKS; b++) {
+            fill_block(signal[b], channels, b * ADC_BLOCK_SAMPLES);
+        }
+        monitor_configure(45.0f, 10.0f);
+        mics_start(MONITOR_SAMPLE_RATE, channels);
+        mics_set_calibration(1, 2010, 33000);
+        mics_set_calibration(2, 2090, 31500);
+
+        uint16_t count = ADC_BLOCK_SAMPLES * channels;
+        uint64_t total_ns = 0;
+#ifdef HAVE_TSC
+        uint64_t total_cycles = 0;
+#endif
+        for (uint32_t b = 0; b < blocks; b++) {
+            uint64_t t0 = now_ns();
+#ifdef HAVE_TSC
+            uint64_t tsc = __rdtsc();
+#endif
+            mics_push_interleaved(signal[b % SIGNAL_BLOCKS], count);
+#ifdef HAVE_TSC
+            total_cycles += __rdtsc() - tsc;
+#endif
+            uint64_t elapsed = now_ns() - t0;
+            total_ns += elapsed;
+            times[b] = elapsed;
+            // El bucle principal vacía el anillo fuera de la interrupción
+            monitor_task();
+        }
+        while (monitor_busy()) {
+            monitor_task();
+        }
+
+        qsort(times, blocks, sizeof(uint64_t), compare_u64);
+        double mean_ns = (double)total_ns / blocks;
+        double high_ns = (double)times[(size_t)((blocks - 1) * PERCENTILE / 100.0)];
+        double period_ns = 1e9 * ADC_BLOCK_SAMPLES / MONITOR_SAMPLE_RATE;
+        double fast_rate = (double)ADC_MAX_SAMPLE_RATE / channels;
+        double fast_period_ns = 1e9 * ADC_BLOCK_SAMPLES / fast_rate;
+        char slow[40], fast[48];
+        snprintf(slow, sizeof(slow), "%.0f us (%.2f%%)", period_ns / 1000, 100.0 * high_ns / period_ns);
+        snprintf(fast, sizeof(fast), "%.0f us a %.0f Hz (%.1f%%)%s", fast_period_ns / 1000, fast_rate,
+            100.0 * high_ns / fast_period_ns, high_ns > fast_period_ns ? " PIERDE BLOQUES" : "");
+
+        printf("%-8u %8.1f us %8.1f us %7.1f us", channels, mean_ns / 1000, high_ns / 1000,
+            mean_ns / 1000 / channels);
+#ifdef HAVE_TSC
+        printf(" %14.1f", (double)total_cycles / ((double)blocks * count));
+#endif
+        printf("  %-24s %s\n", slow, fast);
+    }
+    printf("Uso = P99.9 del tiempo por bloque / período del bloque; por encima de 100%% el DMA pisa el buffer.\n");
+    free(times);
+    return 0;
+}
@@ -0,0 +1,294 @@
+/**
+ * @file replay.c
+ * @brief Herramienta de PC para reproducir trazas grabadas con trace.h
+ *
+ * Alimenta los bytes del GPS a gps_feed()/ubx_feed() y los bloques del ADC a
+ * monitor_push_block()/monitor_task(), en el mismo orden en que se grabaron.
+ * Si la traza tiene varios micrófonos los bloques intercalados pasan antes
+ * por mics_push_interleaved(), como en la placa.
+ * Puede ir a la velocidad original (--realtime) o tan rápido como se pueda.
+ * Los tiempos de la traza son de 32 bits y dan la vuelta cada ~71.6 minutos;
+ * aquí se extienden a 64 bits sumando la diferencia con el registro anterior.
+ * El resultado es determinista: la misma traza produce siempre la misma
+ * salida de memoria, cuyo hash se imprime para comparar versiones del código.
+ *
+ * Compilación (SDK de Pico con PICO_PLATFORM=host, que trae las cabeceras
+ * pico/stdlib.h y hardware/uart.h para el PC):
+ *   gcc -I../Librerias replay.c ../Librerias/gps.c ../Librerias/ubx.c
+ *       ../Librerias/monitor.c ../Librerias/adpcm.c ../Librerias/trace.c
+ *       ../Librerias/kernels.c ../Librerias/fmt.c ../Librerias/geofence.c
+ *       ../Librerias/classifier.c ../Librerias/audio_features.c
+ *       ../Librerias/levels.c ../Librerias/mics.c -lm -o replay
+ *
+ * Uso: replay traza.bin [--realtime] [--out salida.bin] [--threshold dB] [--rise dB]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "trace.h"
+#include "gps.h"
+#include "ubx.h"
+#include "monitor.h"
+#include "memory.h"
+#include "adc.h"
+#include "geofence.h"
+#include "geofence_data.h"
+#include "classifier.h"
+#include "mics.h"
+
+#define DEFAULT_THRESHOLD_DB 45.0f ///< Igual que MONITOR_THRESHOLD_DB en main.c
+#define DEFAULT_RISE_DB 10.0f      ///< Igual que MONITOR_RISE_DB en main.c
+
+/**
+ * @brief Estadísticas de latencia de un tipo de registro
+ */
+typedef struct {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+} latency_t;
+
+static FILE *memory_file;
+static uint64_t memory_hash = 1469598103934665603ULL; ///< FNV-1a de todo lo escrito en memoria
+static uint64_t memory_bytes;
+
+/**
+ * @brief Versión para PC del módulo de memoria: escribe a un archivo y calcula el hash
+ */
+void memory_init(void) {
+}
+
+void memory_write_bytes(const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        memory_hash = (memory_hash ^ data[i]) * 1099511628211ULL;
+    }
+    memory_bytes += length;
+    if (memory_file) {
+        fwrite(data, 1, length, memory_file);
+    }
+}
+
+void memory_write(const char *data) {
+    memory_write_bytes((const uint8_t *)data, strlen(data));
+}
+
+/**
+ * @brief Versión para PC de la captura del ADC: los bloques salen de la traza
+ */
+void adc_dma_start(uint32_t fsample, adc_block_callback_t callback) {
+    (void)fsample;
+    (void)callback;
+}
+
+void adc_dma_start_channels(uint32_t fsample, uint8_t channels, adc_block_callback_t callback) {
+    (void)fsample;
+    (void)channels;
+    (void)callback;
+}
+
+void adc_dma_stop(void) {
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void latency_add(latency_t *l, uint64_t ns) {
+    if (l->count == 0 || ns < l->min_ns) {
+        l->min_ns = ns;
+    }
+    if (ns > l->max_ns) {
+        l->max_ns = ns;
+    }
+    l->total_ns += ns;
+    l->count++;
+}
+
+static void latency_print(const char *name, const char *unit, const latency_t *l) {
+    if (l->count == 0) {
+        printf("%-10s sin datos\n", name);
+        return;
+    }
+    printf("%-10s %8llu %s  min %6llu ns  prom %6llu ns  max %6llu ns\n", name,
+        (unsigned long long)l->count, unit, (unsigned long long)l->min_ns,
+        (unsigned long long)(l->total_ns / l->count), (unsigned long long)l->max_ns);
+}
+
+/**
+ * @brief Pasa al monitor la zona de la posición, como gps_task_fn() en main.c
+ */
+static void set_position(int32_t latitude, int32_t longitude, uint32_t utc_ms) {
+    const geofence_zone_t *zone = geofence_lookup(latitude, longitude);
+    monitor_set_position(latitude, longitude);
+    monitor_set_zone(zone ? zone->id : GEOFENCE_NO_ZONE, zone ? geofence_limit_cdb(zone, utc_ms) : 0);
+}
+
+/**
+ * @brief Espera hasta el instante de la traza si se reproduce en tiempo real
+ */
+static void wait_until(uint64_t start_ns, uint64_t timestamp_us) {
+    uint64_t target = start_ns + (uint64_t)timestamp_us * 1000;
+    uint64_t now = now_ns();
+    if (target > now) {
+        struct timespec ts = { (time_t)((target - now) / 1000000000ULL), (long)((target - now) % 1000000000ULL) };
+        nanosleep(&ts, NULL);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *trace_path = NULL;
+    const char *out_path = NULL;
+    bool realtime = false;
+    float threshold_db = DEFAULT_THRESHOLD_DB;
+    float rise_db = DEFAULT_RISE_DB;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--realtime") == 0) {
+            realtime = true;
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold_db = strtof(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--rise") == 0 && i + 1 < argc) {
+            rise_db = strtof(argv[++i], NULL);
+        } else {
+            trace_path = argv[i];
+        }
+    }
+    if (!trace_path) {
+        fprintf(stderr, "Uso: %s traza.bin [--realtime] [--out salida.bin] [--threshold dB] [--rise dB]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *in = fopen(trace_path, "rb");
+    if (!in) {
+        perror(trace_path);
+        return 1;
+    }
+    trace_header_t header;
+    if (fread(&header, sizeof(header), 1, in) != 1 || header.magic != TRACE_MAGIC ||
+        header.version < 1 || header.version > TRACE_VERSION) {
+        fprintf(stderr, "%s no es una traza válida\n", trace_path);
+        fclose(in);
+        return 1;
+    }
+    uint8_t channels = header.version == 1 || header.channels == 0 ? 1 : (uint8_t)header.channels;
+    if (channels > ADC_MAX_CHANNELS) {
+        fprintf(stderr, "%s tiene %u canales, el máximo es %d\n", trace_path, channels, ADC_MAX_CHANNELS);
+        fclose(in);
+        return 1;
+    }
+    if (out_path && !(memory_file = fopen(out_path, "wb"))) {
+        perror(out_path);
+        fclose(in);
+        return 1;
+    }
+
+    monitor_configure(threshold_db, rise_db);
+    if (channels > 1) {
+        mics_start(header.sample_rate, channels);
+    }
+    geofence_init(geofence_data, GEOFENCE_DATA_WORDS);
+
+    static uint8_t payload[UINT16_MAX];
+    trace_record_t record;
+    latency_t uart_latency = { 0 }, adc_latency = { 0 };
+    uint32_t nmea_fixes = 0, ubx_fixes = 0, events = 0, gaps = 0, over_budget = 0;
+    uint32_t last_adc_us = 0, last_timestamp_us = 0;
+    uint64_t timestamp_us = 0, end_us = 0;
+    bool have_adc = false;
+    int32_t latitude, longitude;
+    ubx_nav_t nav;
+    uint64_t start_ns = now_ns();
+
+    while (fread(&record, sizeof(record), 1, in) == 1) {
+        if (fread(payload, 1, record.length, in) != record.length) {
+            fprintf(stderr, "Registro truncado al final de la traza\n");
+            break;
+        }
+        // Diferencia con signo: un registro del GPS puede quedar después de
+        // bloques del ADC más nuevos, así que el tiempo puede retroceder un poco
+        int32_t step_us = (int32_t)(record.timestamp_us - last_timestamp_us);
+        timestamp_us = step_us < 0 && (uint64_t)-(int64_t)step_us > timestamp_us ? 0 : timestamp_us + step_us;
+        last_timestamp_us = record.timestamp_us;
+        if (timestamp_us > end_us) {
+            end_us = timestamp_us;
+        }
+        if (realtime) {
+            wait_until(start_ns, timestamp_us);
+        }
+
+        if (record.type == TRACE_UART) {
+            for (uint16_t i = 0; i < record.length; i++) {
+                uint64_t t0 = now_ns();
+                if (gps_feed((char)payload[i], &latitude, &longitude)) {
+                    set_position(latitude, longitude, gps_time_of_day_ms());
+                    nmea_fixes++;
+                }
+                if (ubx_feed(payload[i], &nav)) {
+                    set_position(ubx_e7_to_e6(nav.lat_e7), ubx_e7_to_e6(nav.lon_e7), ubx_time_of_day_ms(nav.itow));
+                    ubx_fixes++;
+                }
+                latency_add(&uart_latency, now_ns() - t0);
+            }
+        } else if (record.type == TRACE_ADC) {
+            uint16_t count = record.length / sizeof(uint16_t);
+            uint64_t period_us = (uint64_t)(count / channels) * 1000000 / header.sample_rate;
+            if (have_adc && record.timestamp_us - last_adc_us > period_us + period_us / 2) {
+                gaps++;
+            }
+            last_adc_us = record.timestamp_us;
+            have_adc = true;
+
+            static uint16_t samples[UINT16_MAX / sizeof(uint16_t)];
+            memcpy(samples, payload, record.length);
+            uint64_t t0 = now_ns();
+            if (channels > 1) {
+                mics_push_interleaved(samples, count);
+            } else {
+                monitor_push_block(samples, count);
+            }
+            events += monitor_task();
+            uint64_t elapsed = now_ns() - t0;
+            latency_add(&adc_latency, elapsed);
+            if (elapsed > period_us * 1000) {
+                over_budget++;
+            }
+        }
+    }
+    while (monitor_busy()) {
+        events += monitor_task();
+    }
+    uint64_t wall_ns = now_ns() - start_ns;
+    fclose(in);
+    if (memory_file) {
+        fclose(memory_file);
+    }
+
+    double trace_s = end_us / 1e6;
+    double wall_s = wall_ns / 1e9;
+    printf("Traza: %.3f s a %lu Hz, canales: %u, reproducida en %.3f s (%.1fx)\n", trace_s,
+        (unsigned long)header.sample_rate, channels, wall_s, wall_s > 0 ? trace_s / wall_s : 0.0);
+    latency_print("UART", "bytes", &uart_latency);
+    latency_print("ADC", "bloques", &adc_latency);
+    printf("Bloques sobre el presupuesto de tiempo: %lu (clasificador: %lu), huecos en la traza: %lu\n",
+        (unsigned long)over_budget, (unsigned long)classifier_over_budget(), (unsigned long)gaps);
+    printf("Fixes NMEA: %lu, fixes UBX: %lu, errores de checksum UBX: %lu\n",
+        (unsigned long)nmea_fixes, (unsigned long)ubx_fixes, (unsigned long)ubx_checksum_errors());
+    printf("Eventos: %lu, desbordes: %lu, muestras con error del ADC: %lu\n", (unsigned long)events,
+        (unsigned long)monitor_overruns(), (unsigned long)monitor_adc_errors());
+    static levels_t levels;
+    monitor_levels(&levels);
+    printf("Niveles cortos: %lu, L10 %.2f dB, L50 %.2f dB, L90 %.2f dB\n", (unsigned long)levels.count,
+        levels_exceeded(&levels, 10) / 100.0, levels_exceeded(&levels, 50) / 100.0, levels_exceeded(&levels, 90) / 100.0);
+    printf("Salida: %llu bytes, hash %016llx\n", (unsigned long long)memory_bytes, (unsigned long long)memory_hash);
+    return 0;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file sched_bench.c
+ * @brief Herramienta que mide el costo del planificador cooperativo
+ *
+ * Mide con el mismo sched.c del firmware:
+ *  - una vuelta de sched_step() sin tareas listas, con tantas tareas como
+ *    main.c en modo manual más el monitoreo;
+ *  - el costo por tarea ejecutada, con todas las tareas cediendo la CPU;
+ *  - la ida y vuelta de un evento entre dos tareas (sched_post() y TASK_WAIT);
+ *  - una simulación de main.c: pulsador cada BUTTON_POLL_MS, GPS cada
+ *    GPS_POLL_MS y guardado cada MONITOR_POLL_MS, con una medición cancelada
+ *    que deja el LED rojo tres segundos. Se mide cada cuánto corre la tarea
+ *    del GPS y cuánto tiempo se va en el planificador.
+ * El bucle anterior con sleep_ms() no gastaba CPU en planificar, pero no leía
+ * el GPS durante esas esperas: 1000 ms entre lecturas del ADC y 3000 ms con
+ * el LED rojo, contra una FIFO del UART que se llena en ~33 ms a 9600
+ * baudios. En UBX se compara el peor período del GPS con el anillo de
+ * recepción de ubx.c. Compila para el PC (PICO_PLATFORM=host) y para la Pico.
+ *
+ * Compilación (SDK de Pico con PICO_PLATFORM=host, como replay.c):
+ *   gcc -O2 -I../Librerias sched_bench.c ../Librerias/sched.c -o sched_bench
+ * Uso: sched_bench
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "sched.h"
+
+#define BUTTON_POLL_MS 20     ///< Igual que en main.c
+#define GPS_POLL_MS 10        ///< Igual que en main.c
+#define MONITOR_POLL_MS 4     ///< Igual que en main.c
+#define ABORT_LED_MS 3000     ///< LED rojo de una medición cancelada
+#define SIM_MS 4000           ///< Duración de la simulación de main.c
+#define MICRO_STEPS 200000    ///< Vueltas por medición de los casos sintéticos
+#define UART_FIFO_BYTES 32    ///< FIFO de recepción del UART del RP2040
+#define UBX_RING_BYTES 1024   ///< Igual que UBX_RX_RING_BYTES en ubx.c
+#define UBX_BYTES_PER_S 11520 ///< 115200 baudios, 10 bits por byte
+
+#define EV_PING (1u << 0)
+#define EV_PONG (1u << 1)
+#define EV_ABORT (1u << 2)
+
+static sched_task_t tasks[6];
+static volatile uint32_t body_runs;
+
+static uint64_t gps_last_us, gps_max_gap_us, gps_total_gap_us, gps_runs;
+
+static void sleeper_fn(sched_task_t *t) {
+    TASK_BEGIN(t);
+    while (true) {
+        TASK_SLEEP(t, 60000);
+    }
+    TASK_END(t);
+}
+
+static void yielder_fn(sched_task_t *t) {
+    TASK_BEGIN(t);
+    while (true) {
+        body_runs++;
+        TASK_YIELD(t);
+    }
+    TASK_END(t);
+}
+
+static void ping_fn(sched_task_t *t) {
+    TASK_BEGIN(t);
+    while (true) {
+        sched_post(EV_PING);
+        TASK_WAIT(t, EV_PONG, SCHED_FOREVER);
+        body_runs++;
+    }
+    TASK_END(t);
+}
+
+static void pong_fn(sched_task_t *t) {
+    TASK_BEGIN(t);
+    while (true) {
+        TASK_WAIT(t, EV_PING, SCHED_FOREVER);
+        sched_post(EV_PONG);
+    }
+    TASK_END(t);
+}
+
+/**
+ * @brief Tarea con un período fijo, como las de main.c
+ */
+static void periodic_fn(sched_task_t *t) {
+    TASK_BEGIN(t);
+    while (true) {
+        TASK_SLEEP(t, t == &tasks[0] ? BUTTON_POLL_MS : MONITOR_POLL_MS);
+    }
+    TASK_END(t);
+}
+
+static void gps_fn(sched_task_t *t) {
+    TASK_BEGIN(t);
+    while (true) {
+        uint64_t now = time_us_64();
+        if (gps_runs++) {
+            uint64_t gap = now - gps_last_us;
+            gps_total_gap_us += gap;
+            if (gap > gps_max_gap_us) {
+                gps_max_gap_us = gap;
+            }
+        }
+        gps_last_us = now;
+        TASK_SLEEP(t, GPS_POLL_MS);
+    }
+    TASK_END(t);
+}
+
+/**
+ * @brief Medición cancelada: el LED rojo queda encendido ABORT_LED_MS
+ */
+static void led_fn(sched_task_t *t) {
+    TASK_BEGIN(t);
+    TASK_WAIT(t, EV_ABORT, SCHED_FOREVER);
+    TASK_SLEEP(t, ABORT_LED_MS);
+    TASK_END(t);
+}
+
+static void measure_fn(sched_task_t *t) {
+    TASK_BEGIN(t);
+    TASK_SLEEP(t, 100);
+    sched_post(EV_ABORT);
+    TASK_END(t);
+}
+
+/**
+ * @brief Nanosegundos por vuelta de sched_step() con las tareas ya registradas
+ */
+static double time_steps(uint32_t steps) {
+    uint64_t t0 = time_us_64();
+    for (uint32_t i = 0; i < steps; i++) {
+        sched_step();
+    }
+    return (time_us_64() - t0) * 1000.0 / steps;
+}
+
+int main(void) {
+    stdio_init_all();
+#if PICO_ON_DEVICE
+    sleep_ms(2000); // Tiempo para abrir la consola USB
+#endif
+
+    // Vuelta sin tareas listas con 5 tareas dormidas
+    sched_init();
+    for (int i = 0; i < 5; i++) {
+        sched_add(&tasks[i], sleeper_fn);
+    }
+    sched_step();
+    double idle_ns = time_steps(MICRO_STEPS);
+
+    // Despacho: 5 tareas que ceden la CPU en cada vuelta
+    sched_init();
+    for (int i = 0; i < 5; i++) {
+        sched_add(&tasks[i], yielder_fn);
+    }
+    body_runs = 0;
+    double yield_step_ns = time_steps(MICRO_STEPS);
+    double dispatch_ns = yield_step_ns * MICRO_STEPS / body_runs;
+
+    // Ida y vuelta de un evento
+    sched_init();
+    sched_add(&tasks[0], ping_fn);
+    sched_add(&tasks[1], pong_fn);
+    body_runs = 0;
+    double event_step_ns = time_steps(MICRO_STEPS);
+    double round_trip_ns = event_step_ns * MICRO_STEPS / (body_runs ? body_runs : 1);
+
+    printf("Vuelta sin tareas listas (5 tareas): %8.1f ns\n", idle_ns);
+    printf("Por tarea ejecutada (5 cediendo):    %8.1f ns\n", dispatch_ns);
+    printf("Ida y vuelta de un evento:           %8.1f ns\n", round_trip_ns);
+
+    // Simulación de main.c con una medición cancelada
+    sched_init();
+    sched_add(&tasks[0], periodic_fn);  // Pulsador
+    sched_add(&tasks[1], gps_fn);
+    sched_add(&tasks[2], periodic_fn);  // Guardado del monitor
+    sched_add(&tasks[3], led_fn);
+    sched_add(&tasks[4], measure_fn);
+    uint64_t start = time_us_64();
+    uint64_t wakeups = 0;
+    while (time_us_64() - start < (uint64_t)SIM_MS * 1000) {
+        wakeups += sched_step();
+    }
+    double wakeups_per_s = wakeups * 1000.0 / SIM_MS;
+    double busy_share = 100.0 * wakeups_per_s * (dispatch_ns + idle_ns) / 1e9;
+
+    printf("\nSimulación de main.c durante %d ms (LED rojo %d ms):\n", SIM_MS, ABORT_LED_MS);
+    printf("  Tareas despertadas: %.0f por segundo\n", wakeups_per_s);
+    printf("  Período del GPS: prom %.2f ms, max %.2f ms (nominal %d ms)\n",
+        gps_runs > 1 ? gps_total_gap_us / 1000.0 / (gps_runs - 1) : 0.0, gps_max_gap_us / 1000.0, GPS_POLL_MS);
+    printf("  CPU en el planificador: %.4f%% (despertares * (despacho + vuelta))\n", busy_share);
+    printf("  En UBX a 115200 baudios el peor período junta %llu bytes de %d del anillo\n",
+        (unsigned long long)(gps_max_gap_us * UBX_BYTES_PER_S / 1000000), UBX_RING_BYTES);
+    printf("Bucle con sleep_ms(): GPS sin leer hasta %d ms; a 9600 baudios son %d bytes contra %d de FIFO\n",
+        ABORT_LED_MS, ABORT_LED_MS * 960 / 1000, UART_FIFO_BYTES);
+    return 0;
+}
@@ -7,8 +7,11 @@
  */
 
 #include "adc.h"
+#include "trace.h"
 #include "pico/stdlib.h"
 #include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
 
 /**
  * @brief Initializes the ADC module.
@@ -27,3 +30,122 @@ void adc_init(void) {
 uint16_t adc_read(void) {
     return adc_read();
 }
+
+#define ADC_DMA_CH_A 5 ///< Canal DMA para el primer buffer
+#define ADC_DMA_CH_B 6 ///< Canal DMA para el segundo buffer
+#define ADC_CLOCK_HZ 48000000UL ///< Reloj del ADC
+
+static uint16_t adc_dma_buffer[2][ADC_BLOCK_SAMPLES * ADC_MAX_CHANNELS];
+static uint8_t adc_dma_channels = 1;
+static adc_block_callback_t adc_dma_callback;
+
+/**
+ * @brief Configures one of the ping-pong DMA channels.
+ *
+ * @param[in] channel DMA channel to configure.
+ * @param[in] chain_to Channel started when this one completes.
+ * @param[in] dst Destination buffer.
+ */
+static void adc_dma_config_channel(uint channel, uint chain_to, uint16_t *dst) {
+    dma_channel_config cfg = dma_channel_get_default_config(channel);
+    channel_config_set_read_increment(&cfg, false);
+    channel_config_set_write_increment(&cfg, true);
+    channel_config_set_dreq(&cfg, DREQ_ADC);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+    channel_config_set_chain_to(&cfg, chain_to);
+    dma_channel_configure(channel, &cfg, dst, &adc_hw->fifo, ADC_BLOCK_SAMPLES * adc_dma_channels, false);
+    dma_channel_set_irq0_enabled(channel, true);
+}
+
+/**
+ * @brief DMA interrupt: re-arms the finished channel and hands its block over.
+ *
+ * The re-armed channel only starts when the other one chains to it, so the
+ * buffer stays untouched for a full block period.
+ */
+static void adc_dma_irq(void) {
+    for (int i = 0; i < 2; i++) {
+        uint channel = i ? ADC_DMA_CH_B : ADC_DMA_CH_A;
+        if (dma_channel_get_irq0_status(channel)) {
+            dma_channel_acknowledge_irq0(channel);
+            dma_channel_set_write_addr(channel, adc_dma_buffer[i], false);
+            dma_channel_set_trans_count(channel, ADC_BLOCK_SAMPLES * adc_dma_channels, false);
+            // La traza guarda el bloque crudo, antes de separar y calibrar los canales
+            trace_adc_block(adc_dma_buffer[i], ADC_BLOCK_SAMPLES * adc_dma_channels);
+            if (adc_dma_callback) {
+                adc_dma_callback(adc_dma_buffer[i], ADC_BLOCK_SAMPLES * adc_dma_channels);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Configures the ADC and both DMA channels and starts the capture.
+ *
+ * @param[in] fsample Sampling frequency per channel in Hz.
+ * @param[in] channels Number of inputs sampled in round-robin from ADC0.
+ */
+static void adc_dma_begin(uint32_t fsample, uint8_t channels) {
+    assert(channels >= 1 && channels <= ADC_MAX_CHANNELS);
+    assert(fsample * channels <= ADC_MAX_SAMPLE_RATE);
+    adc_dma_channels = channels;
+
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        adc_gpio_init(26 + ch); // GP26..GP28 (ADC0..ADC2)
+    }
+    adc_select_input(0);
+    adc_set_round_robin(channels > 1 ? (1u << channels) - 1 : 0);
+    adc_set_clkdiv(ADC_CLOCK_HZ / (fsample * channels) - 1);
+    adc_fifo_setup(true, true, 1, true, false);
+    adc_fifo_drain();
+
+    dma_channel_claim(ADC_DMA_CH_A);
+    dma_channel_claim(ADC_DMA_CH_B);
+    adc_dma_config_channel(ADC_DMA_CH_A, ADC_DMA_CH_B, adc_dma_buffer[0]);
+    adc_dma_config_channel(ADC_DMA_CH_B, ADC_DMA_CH_A, adc_dma_buffer[1]);
+    irq_set_exclusive_handler(DMA_IRQ_0, adc_dma_irq);
+    irq_set_priority(DMA_IRQ_0, 0);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    dma_channel_start(ADC_DMA_CH_A);
+    adc_run(true);
+}
+
+/**
+ * @brief Starts continuous ADC capture on GP26 using two chained DMA channels.
+ *
+ * @param[in] fsample Sampling frequency in Hz.
+ * @param[in] callback Function called for each completed block.
+ */
+void adc_dma_start(uint32_t fsample, adc_block_callback_t callback) {
+    adc_dma_callback = callback;
+    adc_dma_begin(fsample, 1);
+}
+
+/**
+ * @brief Starts round-robin capture of several microphones with one DMA stream.
+ *
+ * @param[in] fsample Sampling frequency per channel in Hz.
+ * @param[in] channels Number of microphones on ADC0..ADC(channels-1).
+ * @param[in] callback Function called for each completed interleaved block.
+ */
+void adc_dma_start_channels(uint32_t fsample, uint8_t channels, adc_block_callback_t callback) {
+    adc_dma_callback = callback;
+    adc_dma_begin(fsample, channels);
+}
+
+/**
+ * @brief Stops the continuous ADC capture.
+ */
+void adc_dma_stop(void) {
+    adc_run(false);
+    adc_set_round_robin(0);
+    dma_channel_abort(ADC_DMA_CH_A);
+    dma_channel_abort(ADC_DMA_CH_B);
+    dma_channel_set_irq0_enabled(ADC_DMA_CH_A, false);
+    dma_channel_set_irq0_enabled(ADC_DMA_CH_B, false);
+    dma_channel_unclaim(ADC_DMA_CH_A);
+    dma_channel_unclaim(ADC_DMA_CH_B);
+    adc_fifo_drain();
+    adc_dma_callback = NULL;
+}
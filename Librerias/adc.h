@@ -25,4 +25,47 @@ void adc_init(void);
  */
 uint16_t adc_read(void);
 
+#define ADC_BLOCK_SAMPLES 256     ///< Muestras por bloque DMA en modo continuo (por canal)
+#define ADC_MAX_CHANNELS 3        ///< Micrófonos en GP26..GP28 (ADC0..ADC2)
+#define ADC_MAX_SAMPLE_RATE 500000 ///< Tasa total máxima del ADC (muestras/s)
+
+/**
+ * @brief Callback invoked from the DMA interrupt for every completed block.
+ *
+ * @param[in] block Pointer to the raw ADC samples (bit 15 set on conversion error).
+ * @param[in] count Number of samples in the block.
+ */
+typedef void (*adc_block_callback_t)(const uint16_t *block, uint16_t count);
+
+/**
+ * @brief Starts continuous ADC capture on GP26 using two chained DMA channels.
+ *
+ * While one channel fills its buffer the other one is handed to the
+ * callback, so no samples are lost as long as the callback returns
+ * within one block period.
+ *
+ * @param[in] fsample Sampling frequency in Hz.
+ * @param[in] callback Function called for each completed block.
+ */
+void adc_dma_start(uint32_t fsample, adc_block_callback_t callback);
+
+/**
+ * @brief Starts round-robin capture of several microphones with one DMA stream.
+ *
+ * The inputs are sampled in turn starting at ADC0, so the aggregate rate is
+ * fsample * channels and must stay within ADC_MAX_SAMPLE_RATE. The callback
+ * receives the interleaved block of ADC_BLOCK_SAMPLES * channels samples;
+ * mics_push_interleaved() splits and calibrates it.
+ *
+ * @param[in] fsample Sampling frequency per channel in Hz.
+ * @param[in] channels Number of microphones on ADC0..ADC(channels-1).
+ * @param[in] callback Function called for each completed interleaved block.
+ */
+void adc_dma_start_channels(uint32_t fsample, uint8_t channels, adc_block_callback_t callback);
+
+/**
+ * @brief Stops the continuous ADC capture.
+ */
+void adc_dma_stop(void);
+
 #endif // ADC_H
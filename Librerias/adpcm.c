@@ -0,0 +1,149 @@
+/**
+ * @file adpcm.c
+ * @brief Implementación del codificador IMA-ADPCM en punto fijo
+ *
+ * Solo usa sumas, restas y desplazamientos, por lo que corre bien en el
+ * Cortex-M0+ sin FPU ni división por hardware.
+ */
+
+#include "adpcm.h"
+
+static const int16_t step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+
+static const int8_t index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/**
+ * @brief Actualiza predictor e índice con un código de 4 bits
+ *
+ * Es el paso común al codificador y al decodificador, así ambos reconstruyen
+ * exactamente la misma señal.
+ */
+static inline void adpcm_step(int16_t *predictor, uint8_t *step_index, uint8_t code) {
+    int32_t step = step_table[*step_index];
+    int32_t diff = step >> 3;
+    if (code & 4) diff += step;
+    if (code & 2) diff += step >> 1;
+    if (code & 1) diff += step >> 2;
+
+    int32_t value = *predictor + ((code & 8) ? -diff : diff);
+    if (value > 32767) value = 32767;
+    if (value < -32768) value = -32768;
+    *predictor = (int16_t)value;
+
+    int32_t index = *step_index + index_table[code];
+    if (index < 0) index = 0;
+    if (index > 88) index = 88;
+    *step_index = (uint8_t)index;
+}
+
+/**
+ * @brief Escoge el código de 4 bits más cercano a la muestra
+ */
+static inline uint8_t adpcm_quantize(int16_t predictor, uint8_t step_index, int16_t sample) {
+    int32_t step = step_table[step_index];
+    int32_t diff = (int32_t)sample - predictor;
+    uint8_t code = 0;
+
+    if (diff < 0) {
+        code = 8;
+        diff = -diff;
+    }
+    if (diff >= step) {
+        code |= 4;
+        diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        code |= 2;
+        diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        code |= 1;
+    }
+    return code;
+}
+
+/**
+ * @brief Escribe el encabezado del bloque con el estado actual
+ */
+static void adpcm_start_block(adpcm_encoder_t *enc, int16_t first) {
+    enc->predictor = first;
+    enc->block[0] = (uint8_t)(first & 0xFF);
+    enc->block[1] = (uint8_t)((uint16_t)first >> 8);
+    enc->block[2] = enc->step_index;
+    enc->block[3] = 0;
+    enc->count = 1;
+}
+
+/**
+ * @brief Agrega una muestra de 16 bits con signo al bloque actual
+ */
+static void adpcm_put(adpcm_encoder_t *enc, int16_t sample) {
+    if (enc->count == 0) {
+        adpcm_start_block(enc, sample);
+        return;
+    }
+
+    uint8_t code = adpcm_quantize(enc->predictor, enc->step_index, sample);
+    adpcm_step(&enc->predictor, &enc->step_index, code);
+
+    uint16_t nibble = enc->count - 1;
+    uint8_t *byte = &enc->block[ADPCM_HEADER_BYTES + (nibble >> 1)];
+    if (nibble & 1) {
+        *byte |= (uint8_t)(code << 4);
+    } else {
+        *byte = code;
+    }
+
+    if (++enc->count == ADPCM_BLOCK_SAMPLES) {
+        if (enc->writer) {
+            enc->writer(enc->block);
+        }
+        enc->count = 0;
+    }
+}
+
+void adpcm_encoder_init(adpcm_encoder_t *enc, adpcm_block_writer_t writer) {
+    enc->predictor = 0;
+    enc->step_index = 0;
+    enc->count = 0;
+    enc->writer = writer;
+}
+
+void adpcm_encode(adpcm_encoder_t *enc, const uint16_t *samples, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        adpcm_put(enc, (int16_t)(((int32_t)(samples[i] & 0x0FFF) - 2048) << 4));
+    }
+}
+
+void adpcm_flush(adpcm_encoder_t *enc) {
+    int16_t last = enc->predictor;
+    while (enc->count != 0) {
+        adpcm_put(enc, last);
+    }
+}
+
+void adpcm_decode_block(const uint8_t *block, int16_t *out) {
+    int16_t predictor = (int16_t)(block[0] | (block[1] << 8));
+    uint8_t step_index = block[2] > 88 ? 88 : block[2];
+
+    out[0] = predictor;
+    for (int i = 1; i < ADPCM_BLOCK_SAMPLES; i++) {
+        uint8_t byte = block[ADPCM_HEADER_BYTES + ((i - 1) >> 1)];
+        uint8_t code = ((i - 1) & 1) ? (byte >> 4) : (byte & 0x0F);
+        adpcm_step(&predictor, &step_index, code);
+        out[i] = predictor;
+    }
+}
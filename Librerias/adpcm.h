@@ -0,0 +1,76 @@
+/**
+ * @file adpcm.h
+ * @brief Codificador IMA-ADPCM en punto fijo para guardar audio en la flash
+ *
+ * Comprime muestras de 16 bits a 4 bits por muestra usando el formato de
+ * bloques IMA-ADPCM de WAV (mono). Cada bloque empieza con un encabezado que
+ * guarda la primera muestra y el índice de paso, por lo que cualquier bloque
+ * se puede decodificar sin leer los anteriores.
+ */
+
+#ifndef ADPCM_H
+#define ADPCM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ADPCM_BLOCK_BYTES 256 ///< Tamaño de un bloque codificado (block align del WAV)
+#define ADPCM_HEADER_BYTES 4  ///< Primera muestra (int16 LE), índice de paso y un byte reservado
+#define ADPCM_BLOCK_SAMPLES (1 + 2 * (ADPCM_BLOCK_BYTES - ADPCM_HEADER_BYTES)) ///< Muestras por bloque (505)
+
+/**
+ * @brief Función que recibe cada bloque codificado completo
+ *
+ * @param block Bloque de ADPCM_BLOCK_BYTES bytes
+ */
+typedef void (*adpcm_block_writer_t)(const uint8_t *block);
+
+/**
+ * @brief Estado del codificador
+ */
+typedef struct {
+    int16_t predictor;                  ///< Última muestra reconstruida
+    uint8_t step_index;                 ///< Índice en la tabla de pasos
+    uint16_t count;                     ///< Muestras ya puestas en el bloque actual
+    uint8_t block[ADPCM_BLOCK_BYTES];   ///< Bloque en construcción
+    adpcm_block_writer_t writer;        ///< Destino de los bloques completos
+} adpcm_encoder_t;
+
+/**
+ * @brief Inicializa el codificador
+ *
+ * @param enc Estado del codificador
+ * @param writer Función llamada con cada bloque completo
+ */
+void adpcm_encoder_init(adpcm_encoder_t *enc, adpcm_block_writer_t writer);
+
+/**
+ * @brief Codifica muestras del ADC
+ *
+ * Las muestras son de 12 bits sin signo (0..4095) como las entrega el ADC;
+ * se centran y escalan a 16 bits con signo antes de codificarlas.
+ *
+ * @param enc Estado del codificador
+ * @param samples Muestras del ADC
+ * @param count Número de muestras
+ */
+void adpcm_encode(adpcm_encoder_t *enc, const uint16_t *samples, size_t count);
+
+/**
+ * @brief Completa y entrega el bloque parcial, si lo hay
+ *
+ * Las posiciones sobrantes del bloque se rellenan repitiendo la última muestra.
+ *
+ * @param enc Estado del codificador
+ */
+void adpcm_flush(adpcm_encoder_t *enc);
+
+/**
+ * @brief Decodifica un bloque completo
+ *
+ * @param block Bloque de ADPCM_BLOCK_BYTES bytes
+ * @param out Buffer de ADPCM_BLOCK_SAMPLES muestras de 16 bits con signo
+ */
+void adpcm_decode_block(const uint8_t *block, int16_t *out);
+
+#endif // ADPCM_H
@@ -0,0 +1,67 @@
+/**
+ * @file audio_features.c
+ * @brief Implementación de las características espectrales
+ *
+ * Cada nivel de la descomposición de Haar reemplaza los pares (a, b) por su
+ * suma y guarda la energía de sus diferencias: la diferencia es un pasa altos
+ * de la mitad superior de la banda actual y la suma queda para el siguiente
+ * nivel. Sin normalizar, el ruido blanco da la misma energía en todas las
+ * bandas, así que no hace falta corregir la ganancia de cada nivel.
+ */
+
+#include "audio_features.h"
+#include "kernels.h"
+
+static int32_t work[FEATURE_BLOCK_SAMPLES]; ///< Fuera de la pila: se usa desde la interrupción del DMA
+
+void features_init(features_state_t *state) {
+    for (int k = 0; k < FEATURE_BANDS; k++) {
+        state->prev_band_cdb[k] = 0;
+    }
+}
+
+void features_block(features_state_t *state, const uint16_t *block, int32_t features[FEATURE_COUNT]) {
+    block_stats_t stats;
+    kernel_block_stats(block, FEATURE_BLOCK_SAMPLES, &stats);
+    int32_t mean = stats.valid ? (int32_t)((stats.sum + stats.valid / 2) / stats.valid) : 2048;
+
+    // Señal sin DC y cruces por cero (el cero cuenta como positivo)
+    int32_t crossings = 0;
+    int32_t prev_negative = 0;
+    for (int i = 0; i < FEATURE_BLOCK_SAMPLES; i++) {
+        int32_t x = (block[i] & 0x8000) ? 0 : (int32_t)(block[i] & 0x0FFF) - mean;
+        int32_t negative = x < 0;
+        crossings += i > 0 && negative != prev_negative;
+        prev_negative = negative;
+        work[i] = x;
+    }
+
+    uint64_t total = 0;
+    uint64_t weighted = 0;
+    int32_t flux = 0;
+    int n = FEATURE_BLOCK_SAMPLES;
+    for (int k = 0; k < FEATURE_BANDS; k++) {
+        uint64_t energy = 0;
+        n /= 2;
+        for (int i = 0; i < n; i++) {
+            int32_t a = work[2 * i];
+            int32_t b = work[2 * i + 1];
+            int32_t d = a - b;
+            energy += (uint64_t)((int64_t)d * d);
+            work[i] = a + b;
+        }
+        total += energy;
+        weighted += energy * (uint64_t)k;
+
+        int32_t cdb = kernel_power_cdb(energy);
+        int32_t rise = cdb - state->prev_band_cdb[k];
+        flux += rise > 0 ? rise : 0;
+        state->prev_band_cdb[k] = cdb;
+        features[k] = cdb;
+    }
+
+    // El centroide se calcula en 64 bits escalando antes para no perder resolución
+    features[FEATURE_CENTROID] = total ? (int32_t)((weighted * 256 + total / 2) / total) : 0;
+    features[FEATURE_FLUX] = flux;
+    features[FEATURE_ZCR] = crossings;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file audio_features.h
+ * @brief Características espectrales por bloque para clasificar la fuente de ruido
+ *
+ * Para cada bloque del ADC se calculan, solo con enteros y en una pasada:
+ *  - la energía en FEATURE_BANDS bandas de octava, con una descomposición de
+ *    Haar (sumas y diferencias de pares, sin multiplicaciones);
+ *  - el centroide espectral sobre esas bandas;
+ *  - el flujo espectral (subidas de energía por banda respecto al bloque anterior);
+ *  - la tasa de cruces por cero de la señal sin componente DC.
+ *
+ * A 16 kHz las bandas son 4-8 kHz, 2-4 kHz, 1-2 kHz, 500-1000 Hz, 250-500 Hz
+ * y 125-250 Hz. El bloque debe tener FEATURE_BLOCK_SAMPLES muestras.
+ */
+
+#ifndef AUDIO_FEATURES_H
+#define AUDIO_FEATURES_H
+
+#include <stdint.h>
+
+#define FEATURE_BLOCK_SAMPLES 256  ///< Muestras por bloque (igual que ADC_BLOCK_SAMPLES)
+#define FEATURE_BANDS 6            ///< Bandas de octava
+#define FEATURE_CENTROID 6         ///< Índice del centroide (banda * 256, 0 = la más alta)
+#define FEATURE_FLUX 7             ///< Índice del flujo espectral (centésimas de dB)
+#define FEATURE_ZCR 8              ///< Índice de los cruces por cero del bloque
+#define FEATURE_COUNT 9            ///< Características por bloque
+
+/**
+ * @brief Estado entre bloques (para el flujo espectral)
+ */
+typedef struct {
+    int32_t prev_band_cdb[FEATURE_BANDS];
+} features_state_t;
+
+/**
+ * @brief Reinicia el estado
+ *
+ * @param state Estado a reiniciar
+ */
+void features_init(features_state_t *state);
+
+/**
+ * @brief Calcula las características de un bloque
+ *
+ * Las bandas (índices 0 a FEATURE_BANDS - 1) son niveles en centésimas de dB
+ * de la energía de cada banda. Las muestras con error se reemplazan por la
+ * media del bloque.
+ *
+ * @param state Estado entre bloques
+ * @param block Muestras crudas de 12 bits (bit 15 activo en caso de error)
+ * @param features Resultado (FEATURE_COUNT valores)
+ */
+void features_block(features_state_t *state, const uint16_t *block, int32_t features[FEATURE_COUNT]);
+
+#endif // AUDIO_FEATURES_H
@@ -0,0 +1,121 @@
+/**
+ * @file classifier.c
+ * @brief Implementación de la clasificación de la fuente de ruido
+ *
+ * La softmax se calcula con exp(-t) = 2^(-t * log2(e)): la parte entera del
+ * exponente es un desplazamiento y la fraccionaria sale de una tabla de 16
+ * puntos, suficiente para una confianza en porcentaje.
+ */
+
+#include "classifier.h"
+#include "classifier_weights.h"
+#include "pico/stdlib.h"
+
+#define CLASSIFIER_LOG2E_Q8 369 ///< log2(e) en Q8
+
+static const uint16_t pow2_frac_q16[16] = {
+    65535, 62757, 60097, 57549, 55109, 52773, 50535, 48393,
+    46341, 44376, 42495, 40693, 38968, 37316, 35734, 34219
+};
+
+static features_state_t features_state;
+static int32_t ema_q16[CLASSIFIER_MAX_CLASSES]; ///< Media móvil de las probabilidades
+static volatile uint32_t over_budget;
+
+static int32_t clamp(int32_t x, int32_t lo, int32_t hi) {
+    return x < lo ? lo : x > hi ? hi : x;
+}
+
+void classifier_infer(const classifier_model_t *model, const int32_t features[CLASSIFIER_INPUTS], uint32_t probs_q16[CLASSIFIER_MAX_CLASSES]) {
+    int8_t in[CLASSIFIER_INPUTS];
+    int8_t hidden[CLASSIFIER_HIDDEN];
+    int32_t logits[CLASSIFIER_MAX_CLASSES];
+
+    for (int i = 0; i < CLASSIFIER_INPUTS; i++) {
+        int64_t q = ((int64_t)(features[i] - model->in_offset[i]) * model->in_mult_q16[i]) >> 16;
+        in[i] = (int8_t)(q < -127 ? -127 : q > 127 ? 127 : q);
+    }
+
+    for (int h = 0; h < CLASSIFIER_HIDDEN; h++) {
+        int32_t acc = model->b1[h];
+        for (int i = 0; i < CLASSIFIER_INPUTS; i++) {
+            acc += (int32_t)in[i] * model->w1[h][i];
+        }
+        // ReLU y paso a int8
+        int32_t value = acc > 0 ? (int32_t)(((int64_t)acc * model->hidden_mult_q16) >> 16) : 0;
+        hidden[h] = (int8_t)clamp(value, 0, 127);
+    }
+
+    int32_t max_logit = INT32_MIN;
+    for (int c = 0; c < model->class_count; c++) {
+        int32_t acc = model->b2[c];
+        for (int h = 0; h < CLASSIFIER_HIDDEN; h++) {
+            acc += (int32_t)hidden[h] * model->w2[c][h];
+        }
+        logits[c] = (int32_t)(((int64_t)acc * model->out_mult_q16) >> 16);
+        if (logits[c] > max_logit) {
+            max_logit = logits[c];
+        }
+    }
+
+    // Softmax relativa al máximo: todos los exponentes son <= 0
+    uint32_t sum = 0;
+    for (int c = 0; c < model->class_count; c++) {
+        int32_t diff = clamp(max_logit - logits[c], 0, 16 << 8);
+        uint32_t t = (uint32_t)diff * CLASSIFIER_LOG2E_Q8 >> 8;
+        uint32_t shift = t >> 8;
+        probs_q16[c] = shift < 16 ? pow2_frac_q16[(t & 0xFF) >> 4] >> shift : 0;
+        sum += probs_q16[c];
+    }
+    for (int c = 0; c < model->class_count; c++) {
+        probs_q16[c] = (uint32_t)(((uint64_t)probs_q16[c] << 16) / sum);
+    }
+}
+
+const classifier_model_t *classifier_default_model(void) {
+    return &classifier_model;
+}
+
+void classifier_init(void) {
+    features_init(&features_state);
+    for (int c = 0; c < classifier_model.class_count; c++) {
+        ema_q16[c] = 65536 / classifier_model.class_count;
+    }
+    over_budget = 0;
+}
+
+void classifier_push_block(const uint16_t *block, uint16_t count) {
+    if (count != FEATURE_BLOCK_SAMPLES || classifier_model.class_count == 0) {
+        return;
+    }
+    uint32_t start = time_us_32();
+
+    int32_t features[FEATURE_COUNT];
+    uint32_t probs_q16[CLASSIFIER_MAX_CLASSES];
+    features_block(&features_state, block, features);
+    classifier_infer(&classifier_model, features, probs_q16);
+    for (int c = 0; c < classifier_model.class_count; c++) {
+        ema_q16[c] += ((int32_t)probs_q16[c] - ema_q16[c]) >> CLASSIFIER_EMA_SHIFT;
+    }
+
+    if (time_us_32() - start > CLASSIFIER_BUDGET_US) {
+        over_budget++;
+    }
+}
+
+const char *classifier_result(uint8_t *confidence) {
+    int best = 0;
+    for (int c = 1; c < classifier_model.class_count; c++) {
+        if (ema_q16[c] > ema_q16[best]) {
+            best = c;
+        }
+    }
+    if (confidence) {
+        *confidence = (uint8_t)clamp((ema_q16[best] * 100 + 32768) >> 16, 0, 100);
+    }
+    return classifier_model.class_count ? classifier_model.labels[best] : "";
+}
+
+uint32_t classifier_over_budget(void) {
+    return over_budget;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file classifier.h
+ * @brief Clasificación de la fuente de ruido con una red pequeña cuantizada a int8
+ *
+ * Las características de audio_features.h de cada bloque pasan por una red de una
+ * capa oculta (CLASSIFIER_HIDDEN neuronas ReLU) con pesos int8 y sumas en
+ * 32 bits. Las probabilidades de cada bloque se promedian con una media
+ * móvil exponencial de unos 2^CLASSIFIER_EMA_SHIFT bloques, y de ahí salen
+ * la clase y la confianza que se guardan con cada evento.
+ *
+ * Los pesos están en classifier_weights.h, que genera
+ * Herramientas/clasificador.c a partir de clips WAV etiquetados.
+ */
+
+#ifndef CLASSIFIER_H
+#define CLASSIFIER_H
+
+#include <stdint.h>
+#include "audio_features.h"
+
+#define CLASSIFIER_INPUTS FEATURE_COUNT ///< Entradas de la red
+#define CLASSIFIER_HIDDEN 16            ///< Neuronas de la capa oculta
+#define CLASSIFIER_MAX_CLASSES 8        ///< Clases máximas
+#define CLASSIFIER_LABEL_LEN 16         ///< Largo máximo del nombre de una clase (con '\0')
+#define CLASSIFIER_EMA_SHIFT 5          ///< Media móvil de ~32 bloques (~0.5 s a 16 kHz)
+#define CLASSIFIER_BUDGET_US 1000       ///< Tiempo máximo por bloque (6% de un bloque a 16 kHz)
+
+/**
+ * @brief Modelo cuantizado
+ *
+ * Entrada:  q = clamp(((f - in_offset) * in_mult_q16) >> 16, -127, 127)
+ * Oculta:   h = clamp(((b1 + w1 * q) * hidden_mult_q16) >> 16, 0, 127)
+ * Salida:   logit = ((b2 + w2 * h) * out_mult_q16) >> 16, en nats Q8
+ */
+typedef struct {
+    uint8_t class_count;                                     ///< Clases usadas
+    char labels[CLASSIFIER_MAX_CLASSES][CLASSIFIER_LABEL_LEN]; ///< Nombre de cada clase
+    int32_t in_offset[CLASSIFIER_INPUTS];                    ///< Media de cada característica
+    int32_t in_mult_q16[CLASSIFIER_INPUTS];                  ///< Escala de cada característica a int8
+    int8_t w1[CLASSIFIER_HIDDEN][CLASSIFIER_INPUTS];         ///< Pesos de la capa oculta
+    int32_t b1[CLASSIFIER_HIDDEN];                           ///< Sesgos de la capa oculta
+    int32_t hidden_mult_q16;                                 ///< Escala de la capa oculta a int8
+    int8_t w2[CLASSIFIER_MAX_CLASSES][CLASSIFIER_HIDDEN];    ///< Pesos de la salida
+    int32_t b2[CLASSIFIER_MAX_CLASSES];                      ///< Sesgos de la salida
+    int32_t out_mult_q16;                                    ///< Escala de la salida a nats Q8
+} classifier_model_t;
+
+/**
+ * @brief Probabilidades de un vector de características
+ *
+ * @param model Modelo
+ * @param features Características de features_block()
+ * @param probs_q16 Probabilidad de cada clase en Q16 (class_count valores)
+ */
+void classifier_infer(const classifier_model_t *model, const int32_t features[CLASSIFIER_INPUTS], uint32_t probs_q16[CLASSIFIER_MAX_CLASSES]);
+
+/**
+ * @brief Modelo de classifier_weights.h
+ *
+ * @return Modelo compilado en el firmware
+ */
+const classifier_model_t *classifier_default_model(void);
+
+/**
+ * @brief Reinicia el extractor y la media de probabilidades
+ */
+void classifier_init(void);
+
+/**
+ * @brief Procesa un bloque del ADC
+ *
+ * Se llama desde la interrupción del DMA, igual que monitor_push_block().
+ * Los bloques de otro tamaño que FEATURE_BLOCK_SAMPLES se ignoran.
+ *
+ * @param block Muestras crudas del ADC (bit 15 activo en caso de error)
+ * @param count Número de muestras del bloque
+ */
+void classifier_push_block(const uint16_t *block, uint16_t count);
+
+/**
+ * @brief Clase más probable según la media de los últimos bloques
+ *
+ * @param confidence Probabilidad de esa clase en porcentaje (puede ser NULL)
+ * @return Nombre de la clase
+ */
+const char *classifier_result(uint8_t *confidence);
+
+/**
+ * @brief Bloques que tardaron más de CLASSIFIER_BUDGET_US
+ *
+ * Se reinicia en classifier_init(). Es solo un diagnóstico: depende del
+ * tiempo real de la CPU, así que no se guarda en los eventos (la salida de
+ * replay.c dejaría de ser reproducible) y replay.c lo informa aparte.
+ *
+ * @return Número de bloques sobre el presupuesto
+ */
+uint32_t classifier_over_budget(void);
+
+#endif // CLASSIFIER_H
@@ -0,0 +1,48 @@
+/**
+ * @file classifier_weights.h
+ * @brief Pesos del clasificador, generado por clasificador a partir de clips sintéticos
+ *
+ * Solo sirven para probar el flujo; hay que reentrenar con grabaciones reales.
+ */
+
+#ifndef CLASSIFIER_WEIGHTS_H
+#define CLASSIFIER_WEIGHTS_H
+
+#include "classifier.h"
+
+static const classifier_model_t classifier_model = {
+    .class_count = 4,
+    .labels = { "traffic", "construction", "siren", "voices" },
+    .in_offset = { 4655, 5118, 5577, 5877, 5846, 5881, 838, 1118, 58 },
+    .in_mult_q16 = { 1459, 1297, 1177, 1148, 1235, 1172, 8555, 613, 41075 },
+    .w1 = {
+        { 50, -1, -9, -43, -5, -13, -12, -49, -50 },
+        { -45, 38, 40, 36, -4, -18, 8, 2, 0 },
+        { -6, 2, 5, -3, -38, -52, -17, 3, 10 },
+        { -77, -39, -27, -39, -14, -1, -10, -14, 22 },
+        { -42, -20, 26, 42, -7, 0, 7, 2, -2 },
+        { 89, 63, -19, -34, -34, -18, -41, -78, -110 },
+        { -78, -26, 21, 56, 32, 2, 47, 2, 38 },
+        { -27, 5, 19, 6, -5, -13, 10, 9, 101 },
+        { -36, -48, -32, -2, 48, 31, 32, 28, -39 },
+        { -20, -27, -20, -11, 13, 5, 6, -48, -86 },
+        { 48, 10, -26, 3, -2, -11, 43, 5, 86 },
+        { -54, -21, -36, -10, -18, 4, 6, 43, -1 },
+        { 127, 39, -19, -87, -38, -23, -44, 26, -76 },
+        { 124, 46, -30, -62, -40, 5, -5, 7, 4 },
+        { -4, -11, 1, -25, -12, 8, -7, 4, 17 },
+        { -67, -11, 25, 45, 24, 9, 12, 2, 32 },
+    },
+    .b1 = { -202, 2211, 2177, -5415, 613, -1270, 1290, 3211, -2420, -100, 3072, -3752, 774, 2381, -670, 1043 },
+    .hidden_mult_q16 = 567,
+    .w2 = {
+        { -3, -27, -35, 8, 16, -29, 30, -71, 88, 48, -50, 6, 2, -26, 3, 2 },
+        { 11, -101, 39, -114, -39, -75, -34, 72, 4, -24, 104, -97, 4, 76, -2, -47 },
+        { 37, 36, -49, -18, -5, 101, -43, -41, 2, 39, -38, 17, 61, 0, -14, -35 },
+        { -21, 81, 50, 127, 29, -15, 31, 37, -73, -40, 2, 69, -51, -66, 33, 27 },
+    },
+    .b2 = { -264, 464, -326, 126 },
+    .out_mult_q16 = 50708,
+};
+
+#endif // CLASSIFIER_WEIGHTS_H
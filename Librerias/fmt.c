@@ -0,0 +1,144 @@
+/**
+ * @file fmt.c
+ * @brief Implementación del formateo de texto solo con enteros
+ */
+
+#include "fmt.h"
+
+static const uint32_t pow10_table[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+size_t fmt_str(char *buf, const char *s) {
+    size_t n = 0;
+    while (s[n]) {
+        buf[n] = s[n];
+        n++;
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+size_t fmt_char(char *buf, char c) {
+    buf[0] = c;
+    buf[1] = '\0';
+    return 1;
+}
+
+/**
+ * @brief Escribe exactamente width dígitos, con ceros a la izquierda
+ */
+static size_t fmt_digits(char *buf, uint32_t value, uint8_t width) {
+    for (int i = width - 1; i >= 0; i--) {
+        buf[i] = (char)('0' + value % 10);
+        value /= 10;
+    }
+    buf[width] = '\0';
+    return width;
+}
+
+size_t fmt_uint(char *buf, uint32_t value) {
+    uint8_t width = 1;
+    while (width < 10 && value >= pow10_table[width]) {
+        width++;
+    }
+    return fmt_digits(buf, value, width);
+}
+
+size_t fmt_fixed(char *buf, int32_t value, uint8_t decimals, uint8_t digits) {
+    size_t n = 0;
+    uint32_t magnitude = value < 0 ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+
+    if (digits < decimals) {
+        // Redondeo de la mitad alejándose de cero
+        uint32_t div = pow10_table[decimals - digits];
+        magnitude = (magnitude + div / 2) / div;
+        decimals = digits;
+    }
+    if (value < 0 && magnitude != 0) {
+        buf[n++] = '-';
+    }
+
+    uint32_t scale = pow10_table[decimals];
+    n += fmt_uint(buf + n, magnitude / scale);
+    if (digits == 0) {
+        return n;
+    }
+    buf[n++] = '.';
+    n += fmt_digits(buf + n, magnitude % scale, decimals);
+    while (decimals < digits) {
+        buf[n++] = '0';
+        decimals++;
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+size_t fmt_maps_url(char *buf, int32_t lat_e6, int32_t lon_e6) {
+    size_t n = fmt_str(buf, "https://www.google.com/maps?q=");
+    n += fmt_fixed(buf + n, lat_e6, 6, 6);
+    buf[n++] = ',';
+    n += fmt_fixed(buf + n, lon_e6, 6, 6);
+    return n;
+}
+
+int32_t fmt_parse_fixed(const char *s, uint8_t decimals) {
+    int negative = 0;
+    uint32_t whole = 0;
+    uint32_t frac = 0;
+    uint8_t frac_digits = 0;
+    int round_up = 0;
+
+    if (*s == '-' || *s == '+') {
+        negative = (*s == '-');
+        s++;
+    }
+    while (*s >= '0' && *s <= '9') {
+        whole = whole * 10 + (uint32_t)(*s++ - '0');
+    }
+    if (*s == '.') {
+        s++;
+        while (*s >= '0' && *s <= '9') {
+            if (frac_digits < decimals) {
+                frac = frac * 10 + (uint32_t)(*s - '0');
+                frac_digits++;
+            } else if (frac_digits == decimals) {
+                round_up = (*s >= '5');
+                frac_digits++;
+            }
+            s++;
+        }
+    }
+    if (frac_digits > decimals) {
+        frac_digits = decimals;
+    }
+
+    uint32_t value = whole * pow10_table[decimals] + frac * pow10_table[decimals - frac_digits] + (uint32_t)round_up;
+    return negative ? -(int32_t)value : (int32_t)value;
+}
+
+int32_t fmt_nmea_to_e6(const char *coord, char direction) {
+    uint8_t degree_digits;
+
+    if (direction == 'N' || direction == 'S') {
+        degree_digits = 2;
+    } else if (direction == 'E' || direction == 'W') {
+        degree_digits = 3;
+    } else {
+        return 0;
+    }
+
+    int32_t degrees = 0;
+    for (uint8_t i = 0; i < degree_digits; i++) {
+        if (coord[i] < '0' || coord[i] > '9') {
+            return 0;
+        }
+        degrees = degrees * 10 + (coord[i] - '0');
+    }
+
+    // minutos / 60 en micro-grados = minutos_e5 / 6
+    int32_t minutes_e5 = fmt_parse_fixed(coord + degree_digits, 5);
+    int32_t e6 = degrees * 1000000 + (minutes_e5 + 3) / 6;
+
+    return (direction == 'S' || direction == 'W') ? -e6 : e6;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file fmt.h
+ * @brief Formateo de texto solo con enteros
+ *
+ * Reemplaza a printf/snprintf con %f en las salidas del módulo: coordenadas en
+ * micro-grados, niveles en centésimas de dB y la URL de Google Maps.
+ * Cada función escribe en un buffer del llamador, agrega el '\0' y devuelve
+ * la cantidad de caracteres escritos (sin contar el '\0'), para poder
+ * encadenar llamadas con p += fmt_...(p, ...). Los números con decimales se
+ * escriben igual que lo haría "%f" con el mismo valor.
+ */
+
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FMT_MAPS_URL_MAX 64 ///< Tamaño suficiente para la URL de Google Maps
+
+/**
+ * @brief Copia una cadena
+ *
+ * @param buf Destino
+ * @param s Cadena a copiar
+ * @return Caracteres escritos
+ */
+size_t fmt_str(char *buf, const char *s);
+
+/**
+ * @brief Escribe un carácter
+ *
+ * @param buf Destino (al menos 2 bytes)
+ * @param c Carácter
+ * @return 1
+ */
+size_t fmt_char(char *buf, char c);
+
+/**
+ * @brief Escribe un entero sin signo en decimal, como "%u"
+ *
+ * @param buf Destino (al menos 11 bytes)
+ * @param value Valor
+ * @return Caracteres escritos
+ */
+size_t fmt_uint(char *buf, uint32_t value);
+
+/**
+ * @brief Escribe un número en punto fijo decimal
+ *
+ * El número es value / 10^decimals y se escribe con digits decimales. Si
+ * digits es mayor se completan ceros; si es menor se redondea. Con
+ * decimals = 6 y digits = 6 el resultado coincide con "%f" de value / 1e6.
+ *
+ * @param buf Destino (al menos 24 bytes)
+ * @param value Valor escalado
+ * @param decimals Decimales implícitos en value (0 a 9)
+ * @param digits Decimales a escribir (0 a 9)
+ * @return Caracteres escritos
+ */
+size_t fmt_fixed(char *buf, int32_t value, uint8_t decimals, uint8_t digits);
+
+/**
+ * @brief Escribe la URL de Google Maps de una posición
+ *
+ * Produce el mismo texto que "https://www.google.com/maps?q=%f,%f".
+ *
+ * @param buf Destino (al menos FMT_MAPS_URL_MAX bytes)
+ * @param lat_e6 Latitud en micro-grados
+ * @param lon_e6 Longitud en micro-grados
+ * @return Caracteres escritos
+ */
+size_t fmt_maps_url(char *buf, int32_t lat_e6, int32_t lon_e6);
+
+/**
+ * @brief Lee un número decimal como entero escalado
+ *
+ * "13.5" con decimals = 4 da 135000. Los decimales sobrantes se redondean.
+ *
+ * @param s Texto del número (puede tener signo)
+ * @param decimals Decimales del resultado (0 a 9)
+ * @return Valor escalado por 10^decimals
+ */
+int32_t fmt_parse_fixed(const char *s, uint8_t decimals);
+
+/**
+ * @brief Convierte una coordenada NMEA a micro-grados
+ *
+ * Es la versión entera de convert_to_decimal(): mismo formato de entrada y
+ * mismo resultado redondeado a 6 decimales (los empates exactos se redondean
+ * hacia arriba en magnitud).
+ *
+ * @param coord Coordenada NMEA (ddmm.mmmm o dddmm.mmmm)
+ * @param direction Hemisferio ('N', 'S', 'E', 'W')
+ * @return Coordenada en micro-grados
+ */
+int32_t fmt_nmea_to_e6(const char *coord, char direction);
+
+#endif // FMT_H
@@ -0,0 +1,137 @@
+/**
+ * @file geofence.c
+ * @brief Implementación de la búsqueda de zonas
+ *
+ * La prueba de punto en polígono cuenta los cruces de un rayo hacia el este
+ * con los lados del polígono. La comparación con la intersección se hace con
+ * productos cruzados en 64 bits en lugar de dividir, así el resultado es
+ * exacto en micro-grados y no hace falta punto flotante.
+ */
+
+#include "geofence.h"
+
+static const geofence_header_t *header;
+static const geofence_zone_t *zones;
+static const int32_t *vertices;
+static const uint32_t *cell_start;
+static const uint16_t *cell_zones;
+
+_Static_assert(sizeof(geofence_header_t) % 4 == 0, "El encabezado debe ocupar palabras completas");
+_Static_assert(sizeof(geofence_zone_t) % 4 == 0, "Las zonas deben ocupar palabras completas");
+
+bool geofence_init(const uint32_t *data, size_t words) {
+    header = NULL;
+
+    const geofence_header_t *h = (const geofence_header_t *)data;
+    if (words * 4 < sizeof(*h) || h->magic != GEOFENCE_MAGIC || h->version != GEOFENCE_VERSION) {
+        return false;
+    }
+    size_t cells = (size_t)h->cols * h->rows;
+    size_t need = sizeof(*h) / 4 + h->zone_count * (sizeof(geofence_zone_t) / 4) + h->vertex_count * 2 + cells + 1 + (h->cell_refs + 1) / 2;
+    if (words < need || h->cell_size <= 0) {
+        return false;
+    }
+
+    const uint32_t *p = data + sizeof(*h) / 4;
+    zones = (const geofence_zone_t *)p;
+    p += h->zone_count * (sizeof(geofence_zone_t) / 4);
+    vertices = (const int32_t *)p;
+    p += h->vertex_count * 2;
+    cell_start = p;
+    p += cells + 1;
+    cell_zones = (const uint16_t *)p;
+
+    // Los inicios de celda no pueden retroceder y el último cierra la lista;
+    // si no, una celda recorrería entradas fuera de cell_zones
+    for (size_t i = 0; i < cells; i++) {
+        if (cell_start[i] > cell_start[i + 1]) {
+            return false;
+        }
+    }
+    if (cell_start[cells] != h->cell_refs) {
+        return false;
+    }
+    for (uint32_t i = 0; i < h->zone_count; i++) {
+        if (zones[i].vertex_count < 3 || zones[i].first_vertex + zones[i].vertex_count > h->vertex_count) {
+            return false;
+        }
+    }
+    for (uint32_t k = 0; k < h->cell_refs; k++) {
+        if (cell_zones[k] >= h->zone_count) {
+            return false;
+        }
+    }
+    header = h;
+    return true;
+}
+
+/**
+ * @brief Prueba si un punto está dentro del polígono de una zona
+ */
+static bool zone_contains(const geofence_zone_t *zone, int32_t lat, int32_t lon) {
+    const int32_t *v = vertices + 2 * zone->first_vertex;
+    uint32_t n = zone->vertex_count;
+    bool inside = false;
+
+    int32_t lat_j = v[2 * (n - 1)];
+    int32_t lon_j = v[2 * (n - 1) + 1];
+    for (uint32_t i = 0; i < n; i++) {
+        int32_t lat_i = v[2 * i];
+        int32_t lon_i = v[2 * i + 1];
+        if ((lat_i > lat) != (lat_j > lat)) {
+            // lon < lon_i + (lon_j - lon_i) * (lat - lat_i) / (lat_j - lat_i), sin dividir
+            int64_t lhs = (int64_t)(lon - lon_i) * (lat_j - lat_i);
+            int64_t rhs = (int64_t)(lon_j - lon_i) * (lat - lat_i);
+            if (lat_j > lat_i ? lhs < rhs : lhs > rhs) {
+                inside = !inside;
+            }
+        }
+        lat_j = lat_i;
+        lon_j = lon_i;
+    }
+    return inside;
+}
+
+const geofence_zone_t *geofence_lookup(int32_t lat_e6, int32_t lon_e6) {
+    if (!header) {
+        return NULL;
+    }
+
+    // Las restas se hacen en 64 bits: el punto puede estar muy lejos de la rejilla
+    int64_t dlat = (int64_t)lat_e6 - header->origin_lat;
+    int64_t dlon = (int64_t)lon_e6 - header->origin_lon;
+    if (dlat < 0 || dlon < 0) {
+        return NULL;
+    }
+    int64_t row = dlat / header->cell_size;
+    int64_t col = dlon / header->cell_size;
+    if (row >= header->rows || col >= header->cols) {
+        return NULL;
+    }
+
+    uint32_t cell = (uint32_t)row * header->cols + (uint32_t)col;
+    for (uint32_t k = cell_start[cell]; k < cell_start[cell + 1]; k++) {
+        const geofence_zone_t *zone = &zones[cell_zones[k]];
+        if (lat_e6 < zone->min_lat || lat_e6 > zone->max_lat || lon_e6 < zone->min_lon || lon_e6 > zone->max_lon) {
+            continue;
+        }
+        if (zone_contains(zone, lat_e6, lon_e6)) {
+            return zone;
+        }
+    }
+    return NULL;
+}
+
+int32_t geofence_limit_cdb(const geofence_zone_t *zone, uint32_t utc_ms) {
+    int32_t minute = (int32_t)(utc_ms / 60000) + (header ? header->utc_offset_min : 0);
+    minute = ((minute % 1440) + 1440) % 1440;
+
+    uint16_t day = header ? header->day_start_min : 0;
+    uint16_t night = header ? header->night_start_min : 0;
+    bool is_day = day <= night ? (minute >= day && minute < night) : (minute >= day || minute < night);
+    return is_day ? zone->limit_day_cdb : zone->limit_night_cdb;
+}
+
+uint16_t geofence_zone_count(void) {
+    return header ? header->zone_count : 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file geofence.h
+ * @brief Zonas reguladas con límites de ruido de día y de noche
+ *
+ * Las zonas son polígonos en micro-grados guardados en flash en un formato
+ * compacto de palabras de 32 bits que genera Herramientas/geofence_pack.c a
+ * partir de un archivo de texto:
+ *
+ *   geofence_header_t
+ *   geofence_zone_t   zonas[zone_count]
+ *   int32_t           vértices[vertex_count][2]   (latitud, longitud)
+ *   uint32_t          celdas[cols * rows + 1]     (inicio de cada celda en la lista)
+ *   uint16_t          lista[cell_refs]            (índices de zona, relleno a 32 bits)
+ *
+ * La rejilla uniforme cubre el rectángulo de todas las zonas y cada celda
+ * lista las zonas cuyo rectángulo la toca, así una consulta solo prueba los
+ * polígonos de una celda. La prueba de punto en polígono es entera. Si varias
+ * zonas contienen el punto gana la primera del archivo.
+ */
+
+#ifndef GEOFENCE_H
+#define GEOFENCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define GEOFENCE_MAGIC 0x434E4647u ///< "GFNC" en little-endian
+#define GEOFENCE_VERSION 1         ///< Versión del formato
+#define GEOFENCE_NO_ZONE 0         ///< Identificador usado fuera de toda zona
+
+/**
+ * @brief Encabezado de los datos de zonas
+ */
+typedef struct {
+    uint32_t magic;            ///< GEOFENCE_MAGIC
+    uint16_t version;          ///< GEOFENCE_VERSION
+    uint16_t zone_count;       ///< Número de zonas
+    uint32_t vertex_count;     ///< Vértices de todas las zonas
+    uint32_t cell_refs;        ///< Entradas de la lista de zonas por celda
+    int32_t origin_lat;        ///< Esquina sur de la rejilla (micro-grados)
+    int32_t origin_lon;        ///< Esquina oeste de la rejilla (micro-grados)
+    int32_t cell_size;         ///< Lado de cada celda (micro-grados)
+    uint16_t cols;             ///< Celdas en longitud
+    uint16_t rows;             ///< Celdas en latitud
+    int16_t utc_offset_min;    ///< Hora local menos UTC, en minutos
+    uint16_t day_start_min;    ///< Inicio del horario diurno (minuto del día local)
+    uint16_t night_start_min;  ///< Inicio del horario nocturno (minuto del día local)
+    uint16_t reserved;
+} geofence_header_t;
+
+/**
+ * @brief Zona regulada
+ */
+typedef struct {
+    int32_t min_lat;           ///< Rectángulo que contiene el polígono (micro-grados)
+    int32_t min_lon;
+    int32_t max_lat;
+    int32_t max_lon;
+    uint32_t first_vertex;     ///< Primer vértice en la tabla de vértices
+    uint16_t vertex_count;     ///< Vértices del polígono (sin repetir el primero)
+    uint16_t id;               ///< Identificador de la zona (distinto de GEOFENCE_NO_ZONE)
+    int16_t limit_day_cdb;     ///< Límite diurno en centésimas de dB
+    int16_t limit_night_cdb;   ///< Límite nocturno en centésimas de dB
+} geofence_zone_t;
+
+/**
+ * @brief Valida y activa unos datos de zonas
+ *
+ * Los datos no se copian: deben quedar en flash mientras se usen.
+ *
+ * @param data Datos generados por geofence_pack (alineados a 4 bytes)
+ * @param words Tamaño de los datos en palabras de 32 bits
+ * @return true si los datos son válidos, false en caso contrario (quedan sin zonas)
+ */
+bool geofence_init(const uint32_t *data, size_t words);
+
+/**
+ * @brief Busca la zona que contiene un punto
+ *
+ * @param lat_e6 Latitud en micro-grados
+ * @param lon_e6 Longitud en micro-grados
+ * @return La zona, o NULL si el punto no está en ninguna
+ */
+const geofence_zone_t *geofence_lookup(int32_t lat_e6, int32_t lon_e6);
+
+/**
+ * @brief Límite vigente de una zona según la hora
+ *
+ * @param zone Zona (no NULL)
+ * @param utc_ms Milisegundos desde la medianoche UTC
+ * @return Límite en centésimas de dB
+ */
+int32_t geofence_limit_cdb(const geofence_zone_t *zone, uint32_t utc_ms);
+
+/**
+ * @brief Número de zonas cargadas
+ *
+ * @return Zonas de los datos activos
+ */
+uint16_t geofence_zone_count(void);
+
+#endif // GEOFENCE_H
@@ -0,0 +1,25 @@
+/**
+ * @file geofence_data.h
+ * @brief Zonas para geofence_init(), generado por geofence_pack a partir de zonas_ejemplo.txt
+ */
+
+#ifndef GEOFENCE_DATA_H
+#define GEOFENCE_DATA_H
+
+#include <stdint.h>
+
+#define GEOFENCE_DATA_WORDS 71 ///< 3 zonas, 12 vértices, rejilla de 3x3
+
+static const uint32_t geofence_data[GEOFENCE_DATA_WORDS] = {
+    0x434e4647, 0x00030001, 0x0000000c, 0x0000000b, 0x005ed558, 0xfb7eaa18, 0x00002f2d, 0x00030003,
+    0x01a4fed4, 0x000004ec, 0x005ef880, 0xfb7ee0c8, 0x005f0050, 0xfb7ee898, 0x00000000, 0x00030004,
+    0x11941388, 0x005ed558, 0xfb7ebda0, 0x005f2378, 0xfb7f0bc0, 0x00000004, 0x00010004, 0x157c1964,
+    0x005f2378, 0xfb7eaa18, 0x005f5e10, 0xfb7ef838, 0x00000008, 0x00020004, 0x1b581d4c, 0x005ef880,
+    0xfb7ee0c8, 0x005ef880, 0xfb7ee898, 0x005f0050, 0xfb7ee898, 0x005f0050, 0xfb7ee0c8, 0x005ed558,
+    0xfb7ebda0, 0x005ed558, 0xfb7f0bc0, 0x005f2378, 0xfb7f0bc0, 0x005f2378, 0xfb7ebda0, 0x005f2378,
+    0xfb7ebda0, 0x005f2378, 0xfb7ef838, 0x005f5e10, 0xfb7ee4b0, 0x005f4a88, 0xfb7eaa18, 0x00000000,
+    0x00000001, 0x00000003, 0x00000004, 0x00000006, 0x00000008, 0x00000009, 0x0000000a, 0x0000000b,
+    0x0000000b, 0x00000001, 0x00010001, 0x00020001, 0x00020001, 0x00020001, 0x00000002,
+};
+
+#endif // GEOFENCE_DATA_H
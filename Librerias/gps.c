@@ -13,6 +13,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "trace.h"
+#include "fmt.h"
 
 #define UART_ID uart1  ///< ID del UART utilizado para la comunicación GPS
 #define BAUD_RATE 9600 ///< Tasa de baudios para la comunicación UART
@@ -81,22 +83,30 @@ double convert_to_decimal(const char* coord, char direction) {
 
 void parse_gga_sentence(const char* sentence) {
     char time[10], lat[15], ns, lon[15], ew;
+    char hdop[12] = "0", altitude[12] = "0", geoid_sep[12] = "0";
     int fix_quality, num_satellites;
-    float hdop, altitude, geoid_sep;
 
-    sscanf(sentence, "$GPGGA,%9[^,],%14[^,],%c,%14[^,],%c,%d,%d,%f,%f,M,%f,M", 
-        time, lat, &ns, lon, &ew, &fix_quality, &num_satellites, &hdop, &altitude, &geoid_sep);
+    sscanf(sentence, "$GPGGA,%9[^,],%14[^,],%c,%14[^,],%c,%d,%d,%11[^,],%11[^,],M,%11[^,],M", 
+        time, lat, &ns, lon, &ew, &fix_quality, &num_satellites, hdop, altitude, geoid_sep);
 
-    printf("Parsed GGA Sentence: time: %s, lat: %s, ns: %c, lon: %s, ew: %c, fix_quality: %d, num_satellites: %d, hdop: %.2f, altitude: %.2f, geoid_sep: %.2f\n", 
-        time, lat, ns, lon, ew, fix_quality, num_satellites, hdop, altitude, geoid_sep);
+    // Los decimales se escriben con fmt para no depender de printf con %f
+    char hdop_text[24], altitude_text[24], geoid_text[24];
+    fmt_fixed(hdop_text, fmt_parse_fixed(hdop, 2), 2, 2);
+    fmt_fixed(altitude_text, fmt_parse_fixed(altitude, 2), 2, 2);
+    fmt_fixed(geoid_text, fmt_parse_fixed(geoid_sep, 2), 2, 2);
+    printf("Parsed GGA Sentence: time: %s, lat: %s, ns: %c, lon: %s, ew: %c, fix_quality: %d, num_satellites: %d, hdop: %s, altitude: %s, geoid_sep: %s\n", 
+        time, lat, ns, lon, ew, fix_quality, num_satellites, hdop_text, altitude_text, geoid_text);
 
     if (fix_quality > 0) {
-        double latitude = convert_to_decimal(lat, ns);
-        double longitude = convert_to_decimal(lon, ew);
-        printf("Time: %s, Latitude: %f %c, Longitude: %f %c\n", time, latitude, ns, longitude, ew);
+        int32_t latitude = fmt_nmea_to_e6(lat, ns);
+        int32_t longitude = fmt_nmea_to_e6(lon, ew);
+        char lat_text[24], lon_text[24];
+        fmt_fixed(lat_text, latitude, 6, 6);
+        fmt_fixed(lon_text, longitude, 6, 6);
+        printf("Time: %s, Latitude: %s %c, Longitude: %s %c\n", time, lat_text, ns, lon_text, ew);
         
-        char url[100];
-        snprintf(url, sizeof(url), "https://www.google.com/maps?q=%f,%f", latitude, longitude);
+        char url[FMT_MAPS_URL_MAX];
+        fmt_maps_url(url, latitude, longitude);
         printf("Google Maps URL: %s\n", url);
     } else {
         printf("No GPS fix. fix_quality: %d\n", fix_quality);
@@ -112,7 +122,7 @@ void parse_gga_sentence(const char* sentence) {
 
 void read_gps_data() {
     char buffer[256];
-    int index = 0;
+    size_t index = 0;
 
     while (true) {
         if (uart_is_readable(UART_ID)) {
@@ -133,6 +143,86 @@ void read_gps_data() {
     }
 }
 
+static uint32_t fix_time_ms; ///< Hora UTC del último fix (ms desde la medianoche)
+
+/**
+ * @brief Procesa un carácter NMEA recibido del GPS
+ * 
+ * Arma la sentencia en un buffer interno y, al llegar el fin de línea, analiza
+ * las sentencias GGA. No accede al UART, por lo que también sirve para
+ * reproducir trazas grabadas en el PC.
+ * 
+ * @param c Carácter recibido
+ * @param latitude Latitud en micro-grados (se actualiza solo si hay fix)
+ * @param longitude Longitud en micro-grados (se actualiza solo si hay fix)
+ * @return true si se completó una sentencia GGA con fix, false en caso contrario
+ */
+
+bool gps_feed(char c, int32_t *latitude, int32_t *longitude) {
+    static char buffer[256];
+    static size_t index = 0;
+    bool updated = false;
+
+    if (c == '\n' || index >= sizeof(buffer) - 1) {
+        buffer[index] = '\0';
+
+        if (strstr(buffer, "$GPGGA") != NULL) {
+            char time[10], lat[15], ns, lon[15], ew;
+            int fix_quality = 0;
+            sscanf(buffer, "$GPGGA,%9[^,],%14[^,],%c,%14[^,],%c,%d",
+                time, lat, &ns, lon, &ew, &fix_quality);
+
+            if (fix_quality > 0) {
+                *latitude = fmt_nmea_to_e6(lat, ns);
+                *longitude = fmt_nmea_to_e6(lon, ew);
+                // hhmmss.ss en centésimas de segundo
+                uint32_t t = (uint32_t)fmt_parse_fixed(time, 2);
+                fix_time_ms = ((t / 1000000) * 3600 + (t / 10000 % 100) * 60 + (t / 100 % 100)) * 1000 + (t % 100) * 10;
+                updated = true;
+            }
+        }
+
+        index = 0;
+    } else {
+        buffer[index++] = c;
+    }
+
+    return updated;
+}
+
+/**
+ * @brief Hora UTC del último fix recibido por gps_feed()
+ * 
+ * @return Milisegundos desde la medianoche UTC
+ */
+
+uint32_t gps_time_of_day_ms(void) {
+    return fix_time_ms;
+}
+
+/**
+ * @brief Lee sin bloquear los bytes disponibles del GPS
+ * 
+ * Esta función consume los caracteres que haya en el UART y, cuando se completa
+ * una sentencia GGA con fix válido, actualiza la posición.
+ * 
+ * @param latitude Latitud en micro-grados (se actualiza solo si hay fix)
+ * @param longitude Longitud en micro-grados (se actualiza solo si hay fix)
+ * @return true si se obtuvo una nueva posición, false en caso contrario
+ */
+
+bool gps_poll(int32_t *latitude, int32_t *longitude) {
+    bool updated = false;
+
+    while (uart_is_readable(UART_ID)) {
+        char c = uart_getc(UART_ID);
+        trace_uart_byte((uint8_t)c);
+        updated |= gps_feed(c, latitude, longitude);
+    }
+
+    return updated;
+}
+
 
 /*
 EJEMPLO DE CÓMO IMPLEMENTAR 
@@ -12,7 +12,6 @@
 #include "pico/stdlib.h"
 #include "hardware/uart.h"
 #include "hardware/gpio.h"
-#include "hardware/adc.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -63,4 +62,41 @@ void parse_gga_sentence(const char* sentence);
 
 void read_gps_data();
 
+/**
+ * @brief Lee sin bloquear los bytes disponibles del GPS
+ * 
+ * Esta función consume los caracteres que haya en el UART y, cuando se completa
+ * una sentencia GGA con fix válido, actualiza la posición. Está pensada para
+ * llamarse repetidamente desde un bucle que no puede quedarse esperando al GPS.
+ * 
+ * @param latitude Latitud en micro-grados (se actualiza solo si hay fix)
+ * @param longitude Longitud en micro-grados (se actualiza solo si hay fix)
+ * @return true si se obtuvo una nueva posición, false en caso contrario
+ */
+
+bool gps_poll(int32_t *latitude, int32_t *longitude);
+
+/**
+ * @brief Procesa un carácter NMEA recibido del GPS
+ * 
+ * Arma la sentencia en un buffer interno y, al llegar el fin de línea, analiza
+ * las sentencias GGA. No accede al UART, por lo que también sirve para
+ * reproducir trazas grabadas en el PC.
+ * 
+ * @param c Carácter recibido
+ * @param latitude Latitud en micro-grados (se actualiza solo si hay fix)
+ * @param longitude Longitud en micro-grados (se actualiza solo si hay fix)
+ * @return true si se completó una sentencia GGA con fix, false en caso contrario
+ */
+
+bool gps_feed(char c, int32_t *latitude, int32_t *longitude);
+
+/**
+ * @brief Hora UTC del último fix recibido por gps_feed()
+ * 
+ * @return Milisegundos desde la medianoche UTC
+ */
+
+uint32_t gps_time_of_day_ms(void);
+
 #endif
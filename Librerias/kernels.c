@@ -0,0 +1,225 @@
+/**
+ * @file kernels.c
+ * @brief Implementación de los núcleos de cálculo sobre bloques
+ *
+ * La versión SWAR procesa dos muestras de 16 bits por palabra: las sumas se
+ * acumulan en las dos mitades de un registro de 32 bits y se vacían cada
+ * KERNEL_SWAR_CHUNK palabras, antes de que una mitad pueda desbordarse. El
+ * mínimo y el máximo se comparan por mitades con el truco del bit de guarda,
+ * sin saltos.
+ */
+
+#include "kernels.h"
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define KERNEL_SAMPLE_MASK 0x0FFF0FFFu ///< 12 bits de dato en cada mitad
+#define KERNEL_ERROR_BITS 0x00010001u  ///< Bit de error de cada mitad tras desplazar 15
+#define KERNEL_GUARD_BITS 0x80008000u  ///< Bit de guarda para comparar por mitades
+#define KERNEL_SWAR_CHUNK 16           ///< 16 * 4095 cabe en una mitad de 16 bits
+
+/**
+ * @brief Palabra de 32 bits que puede leer un bloque declarado como uint16_t
+ *
+ * Con may_alias el compilador no supone que estas lecturas y las de uint16_t
+ * apuntan a objetos distintos (aliasing estricto).
+ */
+typedef uint32_t __attribute__((may_alias)) kernel_word_t;
+
+/**
+ * @brief Máscara de mitades completas donde a >= b (valores menores a 0x8000)
+ */
+static inline uint32_t swar_ge_mask(uint32_t a, uint32_t b) {
+    uint32_t t = ((a | KERNEL_GUARD_BITS) - b) & KERNEL_GUARD_BITS;
+    return (t >> 15) * 0xFFFFu;
+}
+
+/**
+ * @brief Mínimo sin saltos de dos valores menores a 2^16
+ */
+static inline uint32_t min_u16(uint32_t a, uint32_t b) {
+    int32_t diff = (int32_t)a - (int32_t)b;
+    return b + (uint32_t)(diff & (diff >> 31));
+}
+
+/**
+ * @brief Máximo sin saltos de dos valores menores a 2^16
+ */
+static inline uint32_t max_u16(uint32_t a, uint32_t b) {
+    int32_t diff = (int32_t)a - (int32_t)b;
+    return a - (uint32_t)(diff & (diff >> 31));
+}
+
+/**
+ * @brief Acumuladores comunes a todas las versiones
+ */
+typedef struct {
+    uint32_t sum;
+    uint64_t sum_sq;
+    uint32_t min;
+    uint32_t max;
+    uint32_t errors;
+} kernel_acc_t;
+
+/**
+ * @brief Acumula una muestra suelta (inicio desalineado o final impar)
+ */
+static inline void kernel_one(kernel_acc_t *acc, uint16_t sample) {
+    uint32_t error = sample >> 15;
+    uint32_t keep = error - 1; // 0xFFFFFFFF si es válida, 0 si tiene error
+    uint32_t value = sample & 0x0FFF & keep;
+
+    acc->sum += value;
+    acc->sum_sq += value * value;
+    acc->errors += error;
+    acc->min = min_u16(acc->min, value | (~keep & 0x0FFF));
+    acc->max = max_u16(acc->max, value);
+}
+
+#if defined(__SSE2__)
+
+/**
+ * @brief Versión SSE2 para el PC: ocho muestras por iteración
+ */
+static const uint16_t *kernel_simd(const uint16_t *p, const uint16_t *end, kernel_acc_t *acc) {
+    const __m128i mask12 = _mm_set1_epi16(0x0FFF);
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i vmin = mask12;
+    __m128i vmax = _mm_setzero_si128();
+    __m128i vsum = _mm_setzero_si128();
+    uint32_t lanes[4];
+    int16_t lanes16[8];
+
+    while (end - p >= 8) {
+        // 32 iteraciones * 2 * 4095^2 cabe en un int32 por carril
+        __m128i vsq = _mm_setzero_si128();
+        for (int i = 0; i < 32 && end - p >= 8; i++, p += 8) {
+            __m128i x = _mm_loadu_si128((const __m128i *)p);
+            __m128i err = _mm_srai_epi16(x, 15);
+            __m128i v = _mm_andnot_si128(err, _mm_and_si128(x, mask12));
+            acc->errors += (uint32_t)__builtin_popcount(_mm_movemask_epi8(err)) / 2;
+            vsum = _mm_add_epi32(vsum, _mm_madd_epi16(v, ones));
+            vsq = _mm_add_epi32(vsq, _mm_madd_epi16(v, v));
+            vmin = _mm_min_epi16(vmin, _mm_or_si128(v, _mm_and_si128(err, mask12)));
+            vmax = _mm_max_epi16(vmax, v);
+        }
+        _mm_storeu_si128((__m128i *)lanes, vsq);
+        acc->sum_sq += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+
+    _mm_storeu_si128((__m128i *)lanes, vsum);
+    acc->sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm_storeu_si128((__m128i *)lanes16, vmin);
+    for (int i = 0; i < 8; i++) {
+        acc->min = min_u16(acc->min, (uint16_t)lanes16[i]);
+    }
+    _mm_storeu_si128((__m128i *)lanes16, vmax);
+    for (int i = 0; i < 8; i++) {
+        acc->max = max_u16(acc->max, (uint16_t)lanes16[i]);
+    }
+    return p;
+}
+
+#else
+
+/**
+ * @brief Versión SWAR para el Cortex-M0+: dos muestras por palabra de 32 bits
+ *
+ * @param p Primera muestra, alineada a 4 bytes (el M0+ no admite lecturas
+ *          de palabra desalineadas; kernel_block_stats() separa la primera
+ *          muestra si hace falta)
+ */
+static const uint16_t *kernel_simd(const uint16_t *p, const uint16_t *end, kernel_acc_t *acc) {
+    const kernel_word_t *w = (const kernel_word_t *)p;
+    uint32_t words = (uint32_t)(end - p) / 2;
+    const uint16_t *done = p + 2 * words;
+    uint32_t minw = KERNEL_SAMPLE_MASK;
+    uint32_t maxw = 0;
+
+    while (words) {
+        uint32_t n = words < KERNEL_SWAR_CHUNK ? words : KERNEL_SWAR_CHUNK;
+        uint32_t lane_sum = 0;
+        uint32_t lane_err = 0;
+        uint32_t sq = 0;
+        words -= n;
+
+        while (n--) {
+            uint32_t x = *w++;
+            uint32_t error = (x >> 15) & KERNEL_ERROR_BITS;
+            uint32_t bad = error * 0xFFFFu; // Mitades completas con error
+            uint32_t v = x & ~bad & KERNEL_SAMPLE_MASK;
+            uint32_t lo = v & 0xFFFF;
+            uint32_t hi = v >> 16;
+
+            lane_sum += v;
+            lane_err += error;
+            sq += lo * lo + hi * hi;
+
+            uint32_t vmin = v | (bad & KERNEL_SAMPLE_MASK);
+            uint32_t ge = swar_ge_mask(vmin, minw);
+            minw = (minw & ge) | (vmin & ~ge);
+            ge = swar_ge_mask(v, maxw);
+            maxw = (v & ge) | (maxw & ~ge);
+        }
+
+        acc->sum += (lane_sum & 0xFFFF) + (lane_sum >> 16);
+        acc->errors += (lane_err & 0xFFFF) + (lane_err >> 16);
+        acc->sum_sq += sq;
+    }
+
+    acc->min = min_u16(acc->min, min_u16(minw & 0xFFFF, minw >> 16));
+    acc->max = max_u16(acc->max, max_u16(maxw & 0xFFFF, maxw >> 16));
+    return done;
+}
+
+#endif
+
+static const uint32_t log2_table[33] = {
+    0, 2909, 5732, 8473, 11136, 13727, 16248, 18704, 21098, 23433, 25711,
+    27936, 30109, 32234, 34312, 36346, 38336, 40286, 42196, 44068, 45904,
+    47705, 49472, 51207, 52911, 54584, 56229, 57845, 59434, 60997, 62534,
+    64047, 65536
+};
+
+#define KERNEL_LOG10_2_Q40 5050445260LL ///< 1000 * log10(2) / 2^16 en Q40
+
+int32_t kernel_power_cdb(uint64_t x) {
+    if (x == 0) {
+        return 0;
+    }
+
+    // Se normaliza x para que su bit más alto quede en la posición 31
+    int32_t n = 63 - __builtin_clzll(x);
+    uint32_t m = n > 31 ? (uint32_t)(x >> (n - 31)) : (uint32_t)(x << (31 - n));
+    uint32_t i = (m >> 26) & 31;
+    uint32_t rem = (m >> 10) & 0xFFFF;
+
+    int64_t log2_q16 = ((int64_t)n << 16) + log2_table[i] + ((int64_t)(log2_table[i + 1] - log2_table[i]) * rem >> 16);
+    return (int32_t)((log2_q16 * KERNEL_LOG10_2_Q40 + (1LL << 39)) >> 40);
+}
+
+void kernel_block_stats(const uint16_t *block, uint16_t count, block_stats_t *stats) {
+    kernel_acc_t acc = { 0, 0, 0x0FFF, 0, 0 };
+    const uint16_t *p = block;
+    const uint16_t *end = block + count;
+
+    // Un uint16_t está siempre en una dirección par: basta con una muestra
+    // suelta para que el resto quede alineado a 4 bytes
+    if (((uintptr_t)p & 2) && p < end) {
+        kernel_one(&acc, *p++);
+    }
+    p = kernel_simd(p, end, &acc);
+    while (p < end) {
+        kernel_one(&acc, *p++);
+    }
+
+    stats->sum = acc.sum;
+    stats->sum_sq = acc.sum_sq;
+    stats->min = (uint16_t)acc.min;
+    stats->max = (uint16_t)acc.max;
+    stats->errors = (uint16_t)acc.errors;
+    stats->valid = count - (uint16_t)acc.errors;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file kernels.h
+ * @brief Núcleos de cálculo sobre bloques de muestras del DMA
+ *
+ * Calculan en una sola pasada y solo con enteros la suma, la suma de
+ * cuadrados, el mínimo, el máximo y la cantidad de errores de un bloque del
+ * ADC. Las muestras con el bit 15 activo (error de conversión) se excluyen
+ * sin saltos condicionales. En el Cortex-M0+ se leen dos muestras por palabra
+ * de 32 bits (SWAR); en el PC se usa SSE2 cuando está disponible.
+ */
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stdint.h>
+
+/**
+ * @brief Estadísticas de un bloque de muestras
+ */
+typedef struct {
+    uint32_t sum;     ///< Suma de las muestras válidas
+    uint64_t sum_sq;  ///< Suma de los cuadrados de las muestras válidas
+    uint16_t min;     ///< Muestra válida mínima (4095 si no hay ninguna)
+    uint16_t max;     ///< Muestra válida máxima (0 si no hay ninguna)
+    uint16_t valid;   ///< Muestras válidas
+    uint16_t errors;  ///< Muestras con error de conversión
+} block_stats_t;
+
+/**
+ * @brief Calcula las estadísticas de un bloque del ADC
+ *
+ * @param block Muestras crudas de 12 bits (bit 15 activo en caso de error)
+ * @param count Número de muestras (como máximo 65535)
+ * @param stats Resultado
+ */
+void kernel_block_stats(const uint16_t *block, uint16_t count, block_stats_t *stats);
+
+/**
+ * @brief Energía AC (sin componente DC) de un bloque
+ *
+ * @param stats Estadísticas calculadas con kernel_block_stats()
+ * @return Suma de (x - media)^2 sobre las muestras válidas
+ */
+static inline uint64_t kernel_ac_energy(const block_stats_t *stats) {
+    return stats->valid ? stats->sum_sq - ((uint64_t)stats->sum * stats->sum) / stats->valid : 0;
+}
+
+/**
+ * @brief Logaritmo en punto fijo: 1000 * log10(x)
+ *
+ * Es el nivel de una potencia en centésimas de dB (10 * log10(x) * 100). Para
+ * amplitudes se multiplica por 2. Usa una tabla de 33 puntos con
+ * interpolación lineal; el error es menor a 0.01 dB.
+ *
+ * @param x Valor positivo (para 0 devuelve 0)
+ * @return 1000 * log10(x) redondeado
+ */
+int32_t kernel_power_cdb(uint64_t x);
+
+#endif // KERNELS_H
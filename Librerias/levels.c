@@ -0,0 +1,68 @@
+/**
+ * @file levels.c
+ * @brief Implementación de los niveles estadísticos
+ */
+
+#include "levels.h"
+#include <string.h>
+
+void levels_init(levels_t *levels) {
+    memset(levels, 0, sizeof(*levels));
+    levels->min_cdb = INT32_MAX;
+    levels->max_cdb = INT32_MIN;
+}
+
+void levels_add(levels_t *levels, int32_t level_cdb) {
+    int32_t bin = (level_cdb - LEVELS_MIN_CDB) / LEVELS_BIN_CDB;
+    if (bin < 0) {
+        bin = 0;
+    } else if (bin >= LEVELS_BINS) {
+        bin = LEVELS_BINS - 1;
+    }
+    levels->bins[bin]++;
+    levels->count++;
+    if (level_cdb < levels->min_cdb) {
+        levels->min_cdb = level_cdb;
+    }
+    if (level_cdb > levels->max_cdb) {
+        levels->max_cdb = level_cdb;
+    }
+}
+
+void levels_merge(levels_t *dst, const levels_t *src) {
+    for (int b = 0; b < LEVELS_BINS; b++) {
+        dst->bins[b] += src->bins[b];
+    }
+    dst->count += src->count;
+    if (src->min_cdb < dst->min_cdb) {
+        dst->min_cdb = src->min_cdb;
+    }
+    if (src->max_cdb > dst->max_cdb) {
+        dst->max_cdb = src->max_cdb;
+    }
+}
+
+int32_t levels_exceeded(const levels_t *levels, uint8_t percent) {
+    if (levels->count == 0) {
+        return 0;
+    }
+
+    // Primera casilla, desde arriba, con más del porcentaje pedido por encima o en ella
+    uint64_t target = (uint64_t)levels->count * (percent > 100 ? 100 : percent);
+    uint64_t above = 0;
+    int b = LEVELS_BINS - 1;
+    for (; b > 0; b--) {
+        above += levels->bins[b];
+        if (above * 100 > target) {
+            break;
+        }
+    }
+
+    int32_t level = LEVELS_MIN_CDB + b * LEVELS_BIN_CDB + LEVELS_BIN_CDB / 2;
+    if (level < levels->min_cdb) {
+        level = levels->min_cdb;
+    } else if (level > levels->max_cdb) {
+        level = levels->max_cdb;
+    }
+    return level;
+}
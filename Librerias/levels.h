@@ -0,0 +1,71 @@
+/**
+ * @file levels.h
+ * @brief Niveles estadísticos L10, L50 y L90 con memoria constante
+ *
+ * Los niveles cortos (por ejemplo uno cada ~128 ms) se cuentan en un
+ * histograma de LEVELS_BINS casillas de LEVELS_BIN_CDB centésimas de dB, así
+ * la memoria no depende de la duración del periodo. L_N es el nivel superado
+ * el N% del tiempo y se obtiene recorriendo el histograma desde arriba; el
+ * error es de media casilla (0.05 dB). Dos histogramas se combinan sumando
+ * casillas, lo que permite llevar un resumen por intervalo y uno acumulado.
+ */
+
+#ifndef LEVELS_H
+#define LEVELS_H
+
+#include <stdint.h>
+
+#define LEVELS_MIN_CDB (-2000) ///< Nivel de la primera casilla (-20 dB); los menores caen en ella
+#define LEVELS_BIN_CDB 10      ///< Ancho de cada casilla (0.1 dB)
+#define LEVELS_BINS 1280       ///< Casillas: de -20 dB a 108 dB; los mayores caen en la última
+
+/**
+ * @brief Resumen de un periodo de niveles cortos
+ */
+typedef struct {
+    uint32_t bins[LEVELS_BINS]; ///< Niveles contados en cada casilla
+    uint32_t count;             ///< Niveles totales
+    int32_t min_cdb;            ///< Nivel mínimo exacto
+    int32_t max_cdb;            ///< Nivel máximo exacto
+} levels_t;
+
+/**
+ * @brief Vacía un resumen
+ *
+ * @param levels Resumen
+ */
+void levels_init(levels_t *levels);
+
+/**
+ * @brief Agrega un nivel corto
+ *
+ * Costo constante: una división y un incremento. Se puede llamar desde una
+ * interrupción.
+ *
+ * @param levels Resumen
+ * @param level_cdb Nivel en centésimas de dB
+ */
+void levels_add(levels_t *levels, int32_t level_cdb);
+
+/**
+ * @brief Suma un resumen a otro
+ *
+ * @param dst Resumen que recibe los niveles
+ * @param src Resumen que se agrega (no se modifica)
+ */
+void levels_merge(levels_t *dst, const levels_t *src);
+
+/**
+ * @brief Nivel superado el porcentaje indicado del tiempo
+ *
+ * levels_exceeded(levels, 10) es L10, 50 es L50 y 90 es L90. Con pocos
+ * niveles equivale al método del rango más cercano, y el resultado nunca
+ * sale del mínimo y el máximo exactos.
+ *
+ * @param levels Resumen
+ * @param percent Porcentaje del tiempo (0 a 100)
+ * @return Nivel en centésimas de dB, 0 si el resumen está vacío
+ */
+int32_t levels_exceeded(const levels_t *levels, uint8_t percent);
+
+#endif // LEVELS_H
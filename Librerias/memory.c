@@ -1,26 +1,168 @@
 /**
- * @file memory.h
- * @brief Header file for memory module.
+ * @file memory.c
+ * @brief Implementation file for memory module.
  *
- * This file contains the function declarations for initializing
- * and writing data to non-volatile memory.
+ * The log lives in the upper part of the Pico flash and only grows: bytes
+ * are staged in a RAM page and each full page is programmed with
+ * flash_range_program(). Erasing happens only in memory_init(), before any
+ * capture starts, so while the DMA is running the only flash operation is a
+ * page program (MEMORY_PROGRAM_MAX_US at most). Interrupts are disabled
+ * during the program because XIP is off and handlers run from flash; the
+ * DMA keeps filling the other ping-pong buffer in hardware, and monitor.c
+ * checks that the worst case fits in one block period.
  */
 
-#ifndef MEMORY_H
-#define MEMORY_H
+#include "memory.h"
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+
+#define MEMORY_FLASH_OFFSET (1024 * 1024) ///< Start of the log; the firmware must fit below it
+#define MEMORY_FLASH_BYTES (PICO_FLASH_SIZE_BYTES - MEMORY_FLASH_OFFSET) ///< Size of the log area
+
+static uint8_t page[FLASH_PAGE_SIZE]; ///< Page being filled, 0xFF after page_fill
+static uint32_t page_fill;            ///< Bytes already in page
+static uint32_t write_offset;         ///< Offset of page inside the log area
+static uint32_t dropped;              ///< Bytes not stored because the log is full
+
+/**
+ * @brief Returns a pointer to the log area through XIP.
+ *
+ * @param[in] offset Offset inside the log area.
+ */
+static const uint8_t *memory_flash(uint32_t offset) {
+    return (const uint8_t *)(uintptr_t)(XIP_BASE + MEMORY_FLASH_OFFSET + offset);
+}
+
+/**
+ * @brief Checks that a flash range reads as erased (all 0xFF).
+ */
+static bool memory_erased(uint32_t offset, uint32_t length) {
+    const uint8_t *p = memory_flash(offset);
+    for (uint32_t i = 0; i < length; i++) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Programs the current page, including a partially filled one.
+ *
+ * Unfilled bytes are 0xFF and programming them leaves the flash erased, so
+ * the same page can be programmed again once more bytes arrive.
+ */
+static void memory_program(void) {
+    uint32_t irq = save_and_disable_interrupts();
+    flash_range_program(MEMORY_FLASH_OFFSET + write_offset, page, FLASH_PAGE_SIZE);
+    restore_interrupts(irq);
+}
 
 /**
  * @brief Initializes the memory module.
  *
- * This function sets up the memory hardware, preparing it for use.
+ * Finds the end of the log left by previous runs and erases any leftover
+ * data after it, so later writes never need an erase.
  */
-void memory_init(void);
+void memory_init(void) {
+    // The log only grows: used pages come before the first erased one
+    uint32_t lo = 0, hi = MEMORY_FLASH_BYTES / FLASH_PAGE_SIZE;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (memory_erased(mid * FLASH_PAGE_SIZE, FLASH_PAGE_SIZE)) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    write_offset = lo * FLASH_PAGE_SIZE;
+    page_fill = 0;
+    memset(page, 0xFF, sizeof(page));
+
+    if (lo > 0) {
+        // The last used page may hold a text record flushed by memory_write()
+        const uint8_t *last = memory_flash(write_offset - FLASH_PAGE_SIZE);
+        uint32_t used = FLASH_PAGE_SIZE;
+        while (used > 0 && last[used - 1] == 0xFF) {
+            used--;
+        }
+        if (used < FLASH_PAGE_SIZE) {
+            write_offset -= FLASH_PAGE_SIZE;
+            memcpy(page, last, used);
+            page_fill = used;
+        }
+    }
+    if (write_offset >= MEMORY_FLASH_BYTES) {
+        return;
+    }
+
+    // Data after the end (an older, longer log) is erased now, before any capture
+    uint32_t sector_end = (write_offset / FLASH_SECTOR_SIZE + 1) * FLASH_SECTOR_SIZE;
+    if (!memory_erased(write_offset + FLASH_PAGE_SIZE, sector_end - write_offset - FLASH_PAGE_SIZE)) {
+        write_offset = sector_end;
+        page_fill = 0;
+        memset(page, 0xFF, sizeof(page));
+    }
+    for (uint32_t sector = sector_end; sector < MEMORY_FLASH_BYTES; sector += FLASH_SECTOR_SIZE) {
+        if (!memory_erased(sector, FLASH_SECTOR_SIZE)) {
+            uint32_t irq = save_and_disable_interrupts();
+            flash_range_erase(MEMORY_FLASH_OFFSET + sector, FLASH_SECTOR_SIZE);
+            restore_interrupts(irq);
+        }
+    }
+}
+
+/**
+ * @brief Writes a binary block to memory.
+ *
+ * @param[in] data Pointer to the bytes to be written.
+ * @param[in] length Number of bytes to write.
+ */
+void memory_write_bytes(const uint8_t *data, size_t length) {
+    while (length > 0) {
+        if (write_offset >= MEMORY_FLASH_BYTES) {
+            dropped += length;
+            return;
+        }
+        size_t n = FLASH_PAGE_SIZE - page_fill;
+        if (n > length) {
+            n = length;
+        }
+        memcpy(page + page_fill, data, n);
+        page_fill += n;
+        data += n;
+        length -= n;
+        if (page_fill == FLASH_PAGE_SIZE) {
+            memory_program();
+            write_offset += FLASH_PAGE_SIZE;
+            page_fill = 0;
+            memset(page, 0xFF, sizeof(page));
+        }
+    }
+}
 
 /**
  * @brief Writes data to memory.
  *
+ * Text records are programmed right away, even in a partial page, so a
+ * measurement survives a power cut.
+ *
  * @param[in] data Pointer to the data to be written.
  */
-void memory_write(const char *data);
+void memory_write(const char *data) {
+    memory_write_bytes((const uint8_t *)data, strlen(data));
+    if (page_fill > 0) {
+        memory_program();
+    }
+}
 
-#endif // MEMORY_H
+/**
+ * @brief Bytes that did not fit in the log.
+ *
+ * @return Number of bytes dropped because the log area is full.
+ */
+uint32_t memory_dropped(void) {
+    return dropped;
+}
@@ -3,16 +3,24 @@
  * @brief Header file for memory module.
  *
  * This file contains the function declarations for initializing
- * and writing data to non-volatile memory.
+ * and writing data to non-volatile memory. The data is appended to a log
+ * in the upper half of the Pico flash.
  */
 
 #ifndef MEMORY_H
 #define MEMORY_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+#define MEMORY_PROGRAM_MAX_US 3000 ///< Worst-case 256-byte page program time of the flash (W25Q16JV tPP max)
+
 /**
  * @brief Initializes the memory module.
  *
- * This function sets up the memory hardware, preparing it for use.
+ * This function sets up the memory hardware, preparing it for use. It finds
+ * the end of the log and erases the rest of the log area, which can take
+ * seconds, so it must run before any capture starts.
  */
 void memory_init(void);
 
@@ -23,4 +31,23 @@ void memory_init(void);
  */
 void memory_write(const char *data);
 
+/**
+ * @brief Writes a binary block to memory.
+ *
+ * Must be called from the main loop, never from an interrupt. Bytes are
+ * staged in RAM and each full 256-byte page is programmed with interrupts
+ * disabled for up to MEMORY_PROGRAM_MAX_US.
+ *
+ * @param[in] data Pointer to the bytes to be written.
+ * @param[in] length Number of bytes to write.
+ */
+void memory_write_bytes(const uint8_t *data, size_t length);
+
+/**
+ * @brief Bytes that did not fit in the log.
+ *
+ * @return Number of bytes dropped because the log area is full.
+ */
+uint32_t memory_dropped(void);
+
 #endif // MEMORY_H
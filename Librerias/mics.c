@@ -0,0 +1,137 @@
+/**
+ * @file mics.c
+ * @brief Implementación de la captura de varios micrófonos
+ *
+ * Cada canal mantiene su propia ventana de energías por bloque, así el costo
+ * por bloque crece linealmente con el número de micrófonos. El promedio de
+ * los canales se arma mientras llegan los bloques y se entrega al monitor
+ * cuando llega el último canal. Separar y calibrar el bloque intercalado se
+ * hace aquí y no en adc.c para que no dependa del hardware y se pueda medir
+ * en el PC.
+ */
+
+#include "mics.h"
+#include "adc.h"
+#include "monitor.h"
+#include "kernels.h"
+
+#define MICS_GAIN_ONE 32768 ///< Ganancia unitaria en Q15
+
+static uint8_t mic_count = 1;
+
+static int16_t cal_offset[ADC_MAX_CHANNELS] = { 2048, 2048, 2048 };
+static int32_t cal_gain[ADC_MAX_CHANNELS] = { MICS_GAIN_ONE, MICS_GAIN_ONE, MICS_GAIN_ONE };
+static uint16_t channel_block[ADC_BLOCK_SAMPLES];
+
+static uint64_t block_energy[ADC_MAX_CHANNELS][MICS_WINDOW_BLOCKS];
+static uint16_t block_count[ADC_MAX_CHANNELS][MICS_WINDOW_BLOCKS];
+static uint64_t window_energy[ADC_MAX_CHANNELS];
+static uint32_t window_count[ADC_MAX_CHANNELS];
+static uint32_t blocks_seen[ADC_MAX_CHANNELS];
+static volatile uint32_t window_ms[ADC_MAX_CHANNELS];
+
+static uint16_t mix_sum[ADC_BLOCK_SAMPLES]; ///< Suma de las muestras válidas de cada posición
+static uint8_t mix_valid[ADC_BLOCK_SAMPLES]; ///< Canales válidos en cada posición
+static uint16_t mix_block[ADC_BLOCK_SAMPLES];
+
+void mics_start(uint32_t fsample, uint8_t channels) {
+    mic_count = channels;
+    adc_dma_start_channels(fsample, channels, mics_push_interleaved);
+}
+
+void mics_set_calibration(uint8_t channel, int16_t offset, int32_t gain_q15) {
+    if (channel < ADC_MAX_CHANNELS) {
+        cal_offset[channel] = offset;
+        cal_gain[channel] = gain_q15;
+    }
+}
+
+void mics_push_interleaved(const uint16_t *block, uint16_t count) {
+    uint8_t channels = mic_count;
+    uint16_t per_channel = count / channels;
+
+    if (per_channel > ADC_BLOCK_SAMPLES) {
+        per_channel = ADC_BLOCK_SAMPLES;
+    }
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        const uint16_t *src = block + ch;
+        int32_t offset = cal_offset[ch];
+        int32_t gain = cal_gain[ch];
+
+        for (uint16_t i = 0; i < per_channel; i++, src += channels) {
+            uint16_t raw = *src;
+            if (raw & (1 << 15)) {
+                channel_block[i] = raw;
+                continue;
+            }
+            int32_t value = ((((int32_t)raw - offset) * gain) >> 15) + 2048;
+            if (value < 0) value = 0;
+            if (value > 4095) value = 4095;
+            channel_block[i] = (uint16_t)value;
+        }
+        mics_push_block(ch, channel_block, per_channel);
+    }
+}
+
+void mics_push_block(uint8_t channel, const uint16_t *block, uint16_t count) {
+    block_stats_t stats;
+
+    if (count > ADC_BLOCK_SAMPLES) {
+        count = ADC_BLOCK_SAMPLES;
+    }
+    if (channel == 0) {
+        for (uint16_t i = 0; i < count; i++) {
+            mix_sum[i] = 0;
+            mix_valid[i] = 0;
+        }
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t error = block[i] >> 15;
+        mix_sum[i] += block[i] & 0x0FFF & (error - 1);
+        mix_valid[i] += 1 - error;
+    }
+
+    kernel_block_stats(block, count, &stats);
+    uint32_t slot = blocks_seen[channel] % MICS_WINDOW_BLOCKS;
+    uint64_t energy = kernel_ac_energy(&stats);
+    window_energy[channel] += energy - block_energy[channel][slot];
+    window_count[channel] += stats.valid - block_count[channel][slot];
+    block_energy[channel][slot] = energy;
+    block_count[channel][slot] = stats.valid;
+    blocks_seen[channel]++;
+    window_ms[channel] = window_count[channel] ? (uint32_t)(window_energy[channel] / window_count[channel]) : 0;
+
+    if (channel + 1 < mic_count) {
+        return;
+    }
+
+    // Promedio sin división: 1/3 se aproxima con 21846 / 2^16
+    for (uint16_t i = 0; i < count; i++) {
+        switch (mix_valid[i]) {
+        case 0: mix_block[i] = 1 << 15; break;
+        case 1: mix_block[i] = mix_sum[i]; break;
+        case 2: mix_block[i] = mix_sum[i] >> 1; break;
+        default: mix_block[i] = (uint16_t)(((uint32_t)mix_sum[i] * 21846) >> 16); break;
+        }
+    }
+    monitor_push_block(mix_block, count);
+}
+
+uint8_t mics_channels(void) {
+    return mic_count;
+}
+
+int32_t mics_level_cdb(uint8_t channel) {
+    return channel < mic_count ? monitor_ms_to_cdb(window_ms[channel]) : 0;
+}
+
+uint8_t mics_loudest(void) {
+    uint8_t loudest = 0;
+    for (uint8_t ch = 1; ch < mic_count; ch++) {
+        if (window_ms[ch] > window_ms[loudest]) {
+            loudest = ch;
+        }
+    }
+    return loudest;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file mics.h
+ * @brief Captura de varios micrófonos en modo round-robin del ADC
+ *
+ * Con dos o tres micrófonos en GP26..GP28 se calcula el nivel de cada uno
+ * sobre una ventana deslizante y se entrega al monitor el promedio de los
+ * canales, que tiene menos ruido propio que un solo micrófono. El micrófono
+ * con mayor nivel da una idea aproximada de la dirección de la fuente.
+ */
+
+#ifndef MICS_H
+#define MICS_H
+
+#include <stdint.h>
+
+#define MICS_WINDOW_BLOCKS 32 ///< Bloques en la ventana deslizante de cada canal (~0.5 s a 16 kHz)
+
+/**
+ * @brief Arranca la captura de los micrófonos y alimenta al monitor
+ *
+ * Antes se deben configurar los umbrales con monitor_configure() y, si hace
+ * falta, la calibración de cada canal con mics_set_calibration().
+ *
+ * @param fsample Frecuencia de muestreo por micrófono (Hz)
+ * @param channels Número de micrófonos (1 a ADC_MAX_CHANNELS)
+ */
+void mics_start(uint32_t fsample, uint8_t channels);
+
+/**
+ * @brief Fija la calibración de un canal
+ *
+ * La muestra calibrada es (cruda - offset) * ganancia + 2048, así el silencio
+ * queda a media escala en todos los canales y tienen la misma sensibilidad.
+ *
+ * @param channel Canal del ADC (0 a ADC_MAX_CHANNELS-1)
+ * @param offset Lectura cruda que corresponde al silencio
+ * @param gain_q15 Ganancia en Q15 (32768 = 1.0)
+ */
+void mics_set_calibration(uint8_t channel, int16_t offset, int32_t gain_q15);
+
+/**
+ * @brief Procesa un bloque intercalado del DMA round-robin
+ *
+ * Es el callback que recibe adc_dma_start_channels(): separa los canales,
+ * aplica la calibración y llama a mics_push_block() con cada uno. Las
+ * muestras con error pasan sin cambios. Se expone para poder medirlo en el PC
+ * (Herramientas/mics_bench.c).
+ *
+ * @param block Muestras crudas intercaladas ADC0, ADC1, ... (bit 15 activo en caso de error)
+ * @param count Número total de muestras (ADC_BLOCK_SAMPLES por canal como máximo)
+ */
+void mics_push_interleaved(const uint16_t *block, uint16_t count);
+
+/**
+ * @brief Procesa el bloque de un canal
+ *
+ * Lo llama mics_push_interleaved(); se expone para poder alimentarlo desde
+ * otra fuente, por ejemplo una traza en el PC.
+ *
+ * @param channel Canal del bloque
+ * @param block Muestras calibradas (bit 15 activo en caso de error)
+ * @param count Número de muestras
+ */
+void mics_push_block(uint8_t channel, const uint16_t *block, uint16_t count);
+
+/**
+ * @brief Micrófonos que se están capturando
+ *
+ * @return Número de canales de mics_start(), 1 si no se llamó
+ */
+uint8_t mics_channels(void);
+
+/**
+ * @brief Nivel de la ventana deslizante de un micrófono
+ *
+ * El monitor lo guarda por canal en el encabezado de cada evento.
+ *
+ * @param channel Canal del micrófono
+ * @return Nivel en centésimas de dB, con la misma referencia que el monitor
+ */
+int32_t mics_level_cdb(uint8_t channel);
+
+/**
+ * @brief Micrófono con mayor nivel en la ventana actual
+ *
+ * Va en el encabezado de cada evento como dirección aproximada de la fuente.
+ *
+ * @return Canal con más energía
+ */
+uint8_t mics_loudest(void);
+
+#endif // MICS_H
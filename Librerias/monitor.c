@@ -0,0 +1,388 @@
+/**
+ * @file monitor.c
+ * @brief Implementación del modo de monitoreo continuo con pre-disparo
+ *
+ * La interrupción del DMA entrega bloques de ADC_BLOCK_SAMPLES muestras que se
+ * copian a un buffer circular estático. Cada bloque aporta su energía AC
+ * (calculada con kernel_block_stats()) a una
+ * ventana deslizante y los disparos se evalúan con aritmética entera. El
+ * bucle principal guarda el evento por partes mientras la captura continúa,
+ * por lo que la RAM usada es fija y no se detiene el DMA. El audio se guarda
+ * comprimido en bloques IMA-ADPCM (ver adpcm.h).
+ */
+
+#include "monitor.h"
+#include "adc.h"
+#include "memory.h"
+#include "adpcm.h"
+#include "kernels.h"
+#include "fmt.h"
+#include "geofence.h"
+#include "classifier.h"
+#include "mics.h"
+#include <math.h>
+#include <string.h>
+
+#define MONITOR_RING_MASK (MONITOR_RING_SAMPLES - 1)
+#define MONITOR_GUARD_SAMPLES (8 * ADC_BLOCK_SAMPLES) ///< Margen que no se lee por estar cerca del escritor
+#define MONITOR_ADC_CONVERT (3.3f / ((1 << 12) - 1))  ///< Conversión de ADC a voltaje
+#define MONITOR_DB_REF 0.00226f                        ///< Voltaje de referencia para 0 dB
+#define MONITOR_CDB_OFFSET (-896)                      ///< 20 * log10(MONITOR_ADC_CONVERT / MONITOR_DB_REF) en centésimas de dB
+
+#define MONITOR_CAUSE_LEVEL 'L' ///< Disparo por nivel
+#define MONITOR_CAUSE_RISE 'R'  ///< Disparo por tasa de subida
+
+_Static_assert((MONITOR_RING_SAMPLES & MONITOR_RING_MASK) == 0, "MONITOR_RING_SAMPLES debe ser potencia de 2");
+_Static_assert(MONITOR_PRE_SAMPLES + MONITOR_GUARD_SAMPLES < MONITOR_RING_SAMPLES, "Buffer circular muy pequeño");
+// Mientras se programa una página de la flash las interrupciones están
+// apagadas; el DMA sigue con el otro buffer y la interrupción tiene que
+// atenderse, con el clasificador incluido, antes de que ese buffer se llene
+_Static_assert(MEMORY_PROGRAM_MAX_US + CLASSIFIER_BUDGET_US < (uint64_t)ADC_BLOCK_SAMPLES * 1000000 / MONITOR_SAMPLE_RATE,
+    "Programar la flash tarda más que un bloque del DMA");
+
+static uint16_t ring[MONITOR_RING_SAMPLES];   ///< Audio (12 bits) de los últimos ~2 s
+static volatile uint32_t write_pos;           ///< Muestras totales escritas en el buffer
+static uint16_t last_good = 2048;             ///< Última muestra válida, reemplaza a las erróneas
+static volatile uint32_t adc_errors;          ///< Muestras con error de conversión
+
+static uint64_t block_energy[MONITOR_WINDOW_BLOCKS]; ///< Energía AC de cada bloque de la ventana
+static uint16_t block_count[MONITOR_WINDOW_BLOCKS];  ///< Muestras válidas de cada bloque
+static uint32_t window_ms_history[MONITOR_RISE_BLOCKS];
+static uint64_t window_energy;
+static uint32_t window_count;
+static uint32_t blocks_seen;
+static volatile uint32_t window_ms;           ///< Media cuadrática de la ventana (cuentas^2)
+
+static uint64_t level_energy;                 ///< Energía AC del nivel corto en curso
+static uint32_t level_count;
+static uint32_t level_blocks;
+static levels_t interval_levels[2];           ///< Niveles cortos desde el disparo anterior
+static volatile uint8_t levels_active;        ///< Resumen que llena el DMA; el otro es del último disparo
+static levels_t total_levels;                 ///< Intervalos ya guardados con sus eventos
+
+static uint32_t threshold_ms;                 ///< Umbral de nivel en cuentas^2
+static uint32_t rise_floor_ms;                ///< Nivel mínimo para considerar la tasa de subida
+static uint32_t rise_ratio_q8;                ///< Relación de subida en formato Q8
+
+static volatile bool event_pending;
+static volatile uint32_t event_start;
+static volatile uint32_t event_end;
+static volatile char event_cause;
+static volatile uint32_t event_ms;
+static uint32_t holdoff_until;
+
+static bool committing;
+static uint32_t commit_pos;
+static uint32_t commit_lost;
+static uint32_t overruns;
+static adpcm_encoder_t encoder;
+
+static int32_t position_lat;
+static int32_t position_lon;
+static uint16_t zone_id;
+static int32_t zone_limit_cdb;
+
+float monitor_ms_to_db(uint32_t ms) {
+    if (ms == 0) {
+        return 0.0f;
+    }
+    return 10.0f * log10f((float)ms) + 20.0f * log10f(MONITOR_ADC_CONVERT / MONITOR_DB_REF);
+}
+
+int32_t monitor_ms_to_cdb(uint32_t ms) {
+    if (ms == 0) {
+        return 0;
+    }
+    return kernel_power_cdb(ms) + MONITOR_CDB_OFFSET;
+}
+
+/**
+ * @brief Convierte un nivel en dB a media cuadrática en cuentas^2
+ *
+ * @param db Nivel en dB
+ * @return Media cuadrática
+ */
+static uint32_t db_to_ms(float db) {
+    float rms = MONITOR_DB_REF * powf(10.0f, db / 20.0f) / MONITOR_ADC_CONVERT;
+    float ms = rms * rms;
+    return ms > 4095.0f * 4095.0f ? 4095u * 4095u : (uint32_t)ms;
+}
+
+/**
+ * @brief Guarda en memoria un bloque ADPCM completo
+ *
+ * @param block Bloque de ADPCM_BLOCK_BYTES bytes
+ */
+static void monitor_write_block(const uint8_t *block) {
+    memory_write_bytes(block, ADPCM_BLOCK_BYTES);
+}
+
+/**
+ * @brief Guarda una línea de texto del evento sin relleno
+ *
+ * Las líneas ocupan solo su texto para no restarle compresión al evento.
+ * Se distinguen de los bloques por el cuarto byte, que en un bloque siempre
+ * es 0 (ver Herramientas/adpcm2wav.c), y el primer bloque empieza justo
+ * después del salto de línea del encabezado.
+ *
+ * @param record Buffer con el texto al inicio y dos bytes libres después de end
+ * @param end Fin del texto (sin salto de línea)
+ */
+static void monitor_write_record(char *record, char *end) {
+    *end++ = '\n';
+    *end = '\0';
+    memory_write(record);
+}
+
+void monitor_configure(float threshold_db, float rise_db) {
+    threshold_ms = db_to_ms(threshold_db);
+    rise_floor_ms = db_to_ms(threshold_db - 20.0f);
+    rise_ratio_q8 = (uint32_t)(256.0f * powf(10.0f, rise_db / 10.0f));
+    classifier_init();
+    level_energy = 0;
+    level_count = 0;
+    level_blocks = 0;
+    levels_init(&interval_levels[0]);
+    levels_init(&interval_levels[1]);
+    levels_init(&total_levels);
+    levels_active = 0;
+}
+
+void monitor_init(float threshold_db, float rise_db) {
+    monitor_configure(threshold_db, rise_db);
+    adc_dma_start(MONITOR_SAMPLE_RATE, monitor_push_block);
+}
+
+void monitor_stop(void) {
+    adc_dma_stop();
+}
+
+void monitor_push_block(const uint16_t *block, uint16_t count) {
+    uint32_t pos = write_pos;
+    block_stats_t stats;
+
+    kernel_block_stats(block, count, &stats);
+    classifier_push_block(block, count);
+
+    // Sin errores el bloque se copia tal cual; si hay, cada muestra errónea se
+    // reemplaza por la última válida para que no llegue al audio guardado
+    if (stats.errors == 0) {
+        uint32_t index = pos & MONITOR_RING_MASK;
+        uint32_t first = MONITOR_RING_SAMPLES - index < count ? MONITOR_RING_SAMPLES - index : count;
+        memcpy(&ring[index], block, first * sizeof(uint16_t));
+        memcpy(&ring[0], block + first, (count - first) * sizeof(uint16_t));
+        if (count) {
+            last_good = block[count - 1] & 0x0FFF;
+        }
+    } else {
+        for (uint16_t i = 0; i < count; i++) {
+            uint16_t sample = block[i];
+            if (!(sample & (1 << 15))) {
+                last_good = sample & 0x0FFF;
+            }
+            ring[(pos + i) & MONITOR_RING_MASK] = last_good;
+        }
+        adc_errors += stats.errors;
+    }
+    pos += count;
+    write_pos = pos;
+
+    // Ventana deslizante: se reemplaza el bloque más antiguo por el nuevo
+    uint32_t slot = blocks_seen % MONITOR_WINDOW_BLOCKS;
+    uint64_t energy = kernel_ac_energy(&stats);
+    window_energy += energy - block_energy[slot];
+    window_count += stats.valid - block_count[slot];
+    block_energy[slot] = energy;
+    block_count[slot] = stats.valid;
+    blocks_seen++;
+
+    uint32_t ms = window_count ? (uint32_t)(window_energy / window_count) : 0;
+    window_ms = ms;
+
+    // Nivel corto para L10/L50/L90
+    level_energy += energy;
+    level_count += stats.valid;
+    if (++level_blocks == MONITOR_LEVEL_BLOCKS) {
+        if (level_count) {
+            levels_add(&interval_levels[levels_active], monitor_ms_to_cdb((uint32_t)(level_energy / level_count)));
+        }
+        level_energy = 0;
+        level_count = 0;
+        level_blocks = 0;
+    }
+
+    uint32_t history_slot = blocks_seen % MONITOR_RISE_BLOCKS;
+    uint32_t ms_before = window_ms_history[history_slot];
+    window_ms_history[history_slot] = ms;
+
+    if (blocks_seen < MONITOR_WINDOW_BLOCKS + MONITOR_RISE_BLOCKS || event_pending || (int32_t)(pos - holdoff_until) < 0) {
+        return;
+    }
+
+    char cause = 0;
+    if (ms >= threshold_ms) {
+        cause = MONITOR_CAUSE_LEVEL;
+    } else if (ms >= rise_floor_ms && (uint64_t)ms * 256 >= (uint64_t)ms_before * rise_ratio_q8) {
+        cause = MONITOR_CAUSE_RISE;
+    }
+
+    if (cause) {
+        event_start = pos > MONITOR_PRE_SAMPLES ? pos - MONITOR_PRE_SAMPLES : 0;
+        event_end = pos + MONITOR_POST_SAMPLES;
+        event_cause = cause;
+        event_ms = ms;
+        // El intervalo que termina queda quieto hasta que monitor_task() lo guarde
+        levels_active ^= 1;
+        event_pending = true;
+    }
+}
+
+void monitor_set_position(int32_t latitude, int32_t longitude) {
+    position_lat = latitude;
+    position_lon = longitude;
+}
+
+void monitor_set_zone(uint16_t zone, int32_t limit_cdb) {
+    zone_id = zone;
+    zone_limit_cdb = limit_cdb;
+}
+
+bool monitor_task(void) {
+    if (!event_pending) {
+        return false;
+    }
+
+    if (!committing) {
+        char header[ADPCM_BLOCK_BYTES + 1];
+        char *p = header;
+        int32_t noise_cdb = monitor_ms_to_cdb(event_ms);
+        levels_t *interval = &interval_levels[levels_active ^ 1];
+        p += fmt_str(p, "Event: ");
+        p += fmt_char(p, event_cause);
+        p += fmt_str(p, ", Noise: ");
+        p += fmt_fixed(p, noise_cdb, 2, 2);
+        p += fmt_str(p, " dB, Lat: ");
+        p += fmt_fixed(p, position_lat, 6, 6);
+        p += fmt_str(p, ", Lon: ");
+        p += fmt_fixed(p, position_lon, 6, 6);
+        p += fmt_str(p, ", Zone: ");
+        p += fmt_uint(p, zone_id);
+        p += fmt_str(p, ", Limit: ");
+        p += fmt_fixed(p, zone_limit_cdb, 2, 2);
+        p += fmt_str(p, " dB, Exceeds: ");
+        p += fmt_uint(p, zone_id != GEOFENCE_NO_ZONE && noise_cdb > zone_limit_cdb);
+        p += fmt_str(p, ", L10: ");
+        p += fmt_fixed(p, levels_exceeded(interval, 10), 2, 2);
+        p += fmt_str(p, " dB, L50: ");
+        p += fmt_fixed(p, levels_exceeded(interval, 50), 2, 2);
+        p += fmt_str(p, " dB, L90: ");
+        p += fmt_fixed(p, levels_exceeded(interval, 90), 2, 2);
+        p += fmt_str(p, " dB");
+        uint8_t mics = mics_channels();
+        if (mics > 1) {
+            // Nivel de cada micrófono y el más fuerte, como dirección aproximada
+            p += fmt_str(p, ", Mics: ");
+            for (uint8_t ch = 0; ch < mics; ch++) {
+                p += fmt_str(p, ch ? "/" : "");
+                p += fmt_fixed(p, mics_level_cdb(ch), 2, 2);
+            }
+            p += fmt_str(p, " dB, Loudest: ");
+            p += fmt_uint(p, mics_loudest());
+        }
+        p += fmt_str(p, ", Fs: ");
+        p += fmt_uint(p, MONITOR_SAMPLE_RATE);
+        p += fmt_str(p, ", Samples: ");
+        p += fmt_uint(p, event_end - event_start);
+        p += fmt_str(p, ", Format: IMA-ADPCM");
+        monitor_write_record(header, p);
+        levels_merge(&total_levels, interval);
+        levels_init(interval);
+        commit_pos = event_start;
+        commit_lost = 0;
+        committing = true;
+        adpcm_encoder_init(&encoder, monitor_write_block);
+    }
+
+    // Las posiciones son contadores absolutos: se comparan por diferencia para tolerar el desborde
+    uint32_t available = write_pos;
+    uint32_t oldest = available - (MONITOR_RING_SAMPLES - MONITOR_GUARD_SAMPLES);
+    if ((int32_t)(oldest - event_end) > 0) {
+        oldest = event_end;
+    }
+    if ((int32_t)(commit_pos - oldest) < 0) {
+        // El guardado se atrasó más que el buffer circular: se salta lo perdido
+        commit_lost += oldest - commit_pos;
+        commit_pos = oldest;
+    }
+
+    uint32_t limit = (int32_t)(available - event_end) < 0 ? available : event_end;
+    uint32_t n = (int32_t)(limit - commit_pos) > 0 ? limit - commit_pos : 0;
+    if (n > MONITOR_COMMIT_CHUNK) {
+        n = MONITOR_COMMIT_CHUNK;
+    }
+
+    if (n > 0) {
+        uint32_t index = commit_pos & MONITOR_RING_MASK;
+        uint32_t first = MONITOR_RING_SAMPLES - index;
+        if (first > n) {
+            first = n;
+        }
+        adpcm_encode(&encoder, &ring[index], first);
+        if (n > first) {
+            adpcm_encode(&encoder, &ring[0], n - first);
+        }
+        commit_pos += n;
+    }
+
+    if ((int32_t)(commit_pos - event_end) < 0) {
+        return false;
+    }
+
+    adpcm_flush(&encoder);
+
+    // La clase sale de la media de los últimos bloques, que cubre el final del evento
+    uint8_t confidence;
+    const char *label = classifier_result(&confidence);
+    char footer[ADPCM_BLOCK_BYTES + 1];
+    char *p = footer;
+    p += fmt_str(p, "EventEnd: Lost: ");
+    p += fmt_uint(p, commit_lost);
+    p += fmt_str(p, ", Class: ");
+    p += fmt_str(p, label);
+    p += fmt_str(p, ", Confidence: ");
+    p += fmt_uint(p, confidence);
+    p += fmt_str(p, "%");
+    monitor_write_record(footer, p);
+    if (commit_lost) {
+        overruns++;
+    }
+    committing = false;
+    holdoff_until = event_end;
+    event_pending = false;
+    return true;
+}
+
+void monitor_levels(levels_t *out) {
+    *out = total_levels;
+    levels_merge(out, &interval_levels[levels_active]);
+    if (event_pending && !committing) {
+        // Intervalo de un disparo cuyo encabezado aún no se escribe
+        levels_merge(out, &interval_levels[levels_active ^ 1]);
+    }
+}
+
+bool monitor_busy(void) {
+    return event_pending;
+}
+
+float monitor_level_db(void) {
+    return monitor_ms_to_db(window_ms);
+}
+
+uint32_t monitor_overruns(void) {
+    return overruns;
+}
+
+uint32_t monitor_adc_errors(void) {
+    return adc_errors;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file monitor.h
+ * @brief Modo de monitoreo continuo con buffer circular de pre-disparo
+ *
+ * Este módulo calcula el nivel de ruido sobre una ventana deslizante sin
+ * interrumpir la captura y conserva los últimos segundos de audio crudo en un
+ * buffer circular de tamaño fijo. Cuando se supera un umbral de nivel o una
+ * tasa de subida, guarda en memoria el audio previo y posterior al disparo
+ * junto con la posición GPS. En memoria cada evento es una línea de
+ * encabezado, los bloques IMA-ADPCM de ADPCM_BLOCK_BYTES bytes y una línea
+ * de pie; las líneas ocupan solo su texto. Con varios micrófonos (mics.h) el
+ * encabezado agrega el nivel de cada uno y el canal más fuerte.
+ *
+ * Además cuenta un nivel corto cada MONITOR_LEVEL_BLOCKS bloques en un
+ * resumen de levels.h. Cada evento guarda L10, L50 y L90 de los niveles
+ * desde el disparo anterior, y esos resúmenes se combinan en uno acumulado.
+ */
+
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "levels.h"
+
+#define MONITOR_SAMPLE_RATE 16000   ///< Frecuencia de muestreo del modo continuo (Hz)
+#define MONITOR_RING_SAMPLES 32768  ///< Tamaño del buffer circular (potencia de 2, ~2 s)
+#define MONITOR_PRE_SAMPLES 16000   ///< Muestras guardadas antes del disparo (1 s)
+#define MONITOR_POST_SAMPLES 8000   ///< Muestras guardadas después del disparo (0.5 s)
+#define MONITOR_WINDOW_BLOCKS 32    ///< Bloques DMA en la ventana deslizante (~0.5 s)
+#define MONITOR_RISE_BLOCKS 8       ///< Separación en bloques para medir la tasa de subida
+#define MONITOR_LEVEL_BLOCKS 8      ///< Bloques por nivel corto para L10/L50/L90 (~128 ms, como la ponderación Fast)
+#define MONITOR_COMMIT_CHUNK 512    ///< Muestras escritas en memoria por llamada a monitor_task
+
+/**
+ * @brief Inicializa el monitor y arranca la captura continua del ADC
+ *
+ * @param threshold_db Nivel (dB) de la ventana deslizante que dispara un evento
+ * @param rise_db Subida de nivel (dB) en MONITOR_RISE_BLOCKS bloques que dispara un evento
+ */
+void monitor_init(float threshold_db, float rise_db);
+
+/**
+ * @brief Configura los umbrales de disparo sin arrancar el ADC
+ *
+ * monitor_init() la llama internamente; se usa sola cuando los bloques llegan
+ * de otra fuente, por ejemplo al reproducir una traza en el PC.
+ *
+ * @param threshold_db Nivel (dB) de la ventana deslizante que dispara un evento
+ * @param rise_db Subida de nivel (dB) en MONITOR_RISE_BLOCKS bloques que dispara un evento
+ */
+void monitor_configure(float threshold_db, float rise_db);
+
+/**
+ * @brief Detiene la captura continua
+ */
+void monitor_stop(void);
+
+/**
+ * @brief Agrega un bloque de muestras del DMA al monitor
+ *
+ * Se llama desde la interrupción del DMA. Copia el bloque al buffer circular,
+ * actualiza la ventana deslizante y evalúa los disparos usando solo enteros.
+ *
+ * @param block Muestras crudas del ADC (bit 15 activo en caso de error)
+ * @param count Número de muestras del bloque
+ */
+void monitor_push_block(const uint16_t *block, uint16_t count);
+
+/**
+ * @brief Actualiza la posición que se guardará con el próximo evento
+ *
+ * @param latitude Latitud en micro-grados
+ * @param longitude Longitud en micro-grados
+ */
+void monitor_set_position(int32_t latitude, int32_t longitude);
+
+/**
+ * @brief Actualiza la zona regulada y su límite para el próximo evento
+ *
+ * El encabezado del evento indica la zona y si el nivel del disparo supera
+ * el límite.
+ *
+ * @param zone Identificador de la zona (GEOFENCE_NO_ZONE fuera de toda zona)
+ * @param limit_cdb Límite vigente en centésimas de dB
+ */
+void monitor_set_zone(uint16_t zone, int32_t limit_cdb);
+
+/**
+ * @brief Guarda en memoria el evento pendiente por partes
+ *
+ * Debe llamarse desde el bucle principal. Escribe como máximo
+ * MONITOR_COMMIT_CHUNK muestras por llamada para no bloquear el resto del
+ * programa mientras la captura sigue llenando el buffer circular.
+ *
+ * @return true cuando termina de guardar un evento, false en caso contrario
+ */
+bool monitor_task(void);
+
+/**
+ * @brief Indica si hay un evento disparado que aún no termina de guardarse
+ *
+ * @return true mientras el evento está pendiente
+ */
+bool monitor_busy(void);
+
+/**
+ * @brief Nivel actual de la ventana deslizante
+ *
+ * @return Nivel en dB con la misma referencia que Micro_completo.c
+ */
+float monitor_level_db(void);
+
+/**
+ * @brief Convierte una media cuadrática en cuentas^2 del ADC a dB
+ *
+ * @param ms Media cuadrática (sin componente DC)
+ * @return Nivel en dB con la misma referencia que Micro_completo.c
+ */
+float monitor_ms_to_db(uint32_t ms);
+
+/**
+ * @brief Convierte una media cuadrática en cuentas^2 del ADC a centésimas de dB
+ *
+ * Versión entera de monitor_ms_to_db(), para escribir el nivel sin printf con %f.
+ *
+ * @param ms Media cuadrática (sin componente DC)
+ * @return Nivel en centésimas de dB
+ */
+int32_t monitor_ms_to_cdb(uint32_t ms);
+
+/**
+ * @brief Resumen de todos los niveles cortos desde monitor_configure()
+ *
+ * Combina los intervalos ya guardados con el intervalo en curso. Con la
+ * captura activa el intervalo en curso puede copiarse a medio actualizar,
+ * con un error de a lo sumo un nivel.
+ *
+ * @param out Resumen de salida
+ */
+void monitor_levels(levels_t *out);
+
+/**
+ * @brief Cantidad de eventos en los que se perdió audio por no alcanzar a guardarlo
+ *
+ * @return Número de desbordes del buffer circular
+ */
+uint32_t monitor_overruns(void);
+
+/**
+ * @brief Cantidad de muestras del ADC marcadas con error de conversión
+ *
+ * En el audio guardado esas muestras se reemplazan por la última válida.
+ *
+ * @return Muestras con error desde el arranque
+ */
+uint32_t monitor_adc_errors(void);
+
+#endif // MONITOR_H
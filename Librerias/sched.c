@@ -0,0 +1,234 @@
+/**
+ * @file sched.c
+ * @brief Implementación del planificador cooperativo
+ *
+ * La rueda de temporizadores guarda, en la ranura wake_ms % SCHED_WHEEL_SLOTS,
+ * un bit por cada tarea que vence en ese milisegundo. Al avanzar el reloj solo
+ * se revisan las ranuras de los milisegundos transcurridos, así el costo no
+ * depende de cuántas tareas duermen. Una ranura puede tener tareas de vueltas
+ * futuras de la rueda: por eso se compara además el vencimiento completo.
+ */
+
+#include "sched.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#if PICO_ON_DEVICE
+#include "hardware/timer.h"
+#endif
+
+#define SCHED_WHEEL_MASK (SCHED_WHEEL_SLOTS - 1)
+#define SCHED_ALARM_NUM 2 ///< Alarma de hardware para despertar (la 3 es la del SDK para sleep_ms)
+
+_Static_assert((SCHED_WHEEL_SLOTS & SCHED_WHEEL_MASK) == 0, "SCHED_WHEEL_SLOTS debe ser potencia de 2");
+_Static_assert(SCHED_MAX_TASKS <= 16, "La rueda usa un bit de 16 por tarea");
+
+static sched_task_t *tasks[SCHED_MAX_TASKS];
+static uint8_t task_count;
+static uint16_t wheel[SCHED_WHEEL_SLOTS]; ///< Tareas que vencen en cada ranura (un bit por tarea)
+static uint32_t wheel_ms;                 ///< Último milisegundo revisado en la rueda
+static volatile uint32_t posted;          ///< Eventos publicados aún sin repartir
+
+static uint32_t now_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+#if PICO_ON_DEVICE
+/**
+ * @brief La alarma solo sirve para sacar a la CPU de __wfi()
+ */
+static void sched_alarm(uint alarm_num) {
+    (void)alarm_num;
+}
+#endif
+
+void sched_init(void) {
+    task_count = 0;
+    for (uint32_t i = 0; i < SCHED_WHEEL_SLOTS; i++) {
+        wheel[i] = 0;
+    }
+    wheel_ms = now_ms();
+    posted = 0;
+#if PICO_ON_DEVICE
+    hardware_alarm_claim(SCHED_ALARM_NUM);
+    hardware_alarm_set_callback(SCHED_ALARM_NUM, sched_alarm);
+#endif
+}
+
+bool sched_add(sched_task_t *task, sched_fn_t fn) {
+    if (task_count >= SCHED_MAX_TASKS) {
+        return false;
+    }
+    task->fn = fn;
+    task->line = 0;
+    task->id = task_count;
+    task->state = SCHED_READY;
+    task->wake_ms = 0;
+    task->wait_mask = 0;
+    task->events = 0;
+    tasks[task_count++] = task;
+    return true;
+}
+
+/**
+ * @brief Pone la tarea en la rueda; con 0 ms queda lista de inmediato
+ */
+static void timer_arm(sched_task_t *task, uint32_t ms) {
+    if (ms == 0) {
+        task->state = SCHED_READY;
+        return;
+    }
+    // wheel_ms nunca pasa de now_ms(), así que el vencimiento queda por delante
+    task->wake_ms = now_ms() + ms;
+    wheel[task->wake_ms & SCHED_WHEEL_MASK] |= (uint16_t)(1u << task->id);
+}
+
+static void timer_cancel(sched_task_t *task) {
+    wheel[task->wake_ms & SCHED_WHEEL_MASK] &= (uint16_t)~(1u << task->id);
+}
+
+void sched_sleep(sched_task_t *task, uint32_t ms) {
+    task->state = SCHED_SLEEPING;
+    task->events = 0;
+    timer_arm(task, ms);
+}
+
+void sched_wait(sched_task_t *task, uint32_t mask, uint32_t timeout_ms) {
+    task->state = SCHED_WAITING;
+    task->wait_mask = mask;
+    task->events = 0;
+    if (timeout_ms != SCHED_FOREVER) {
+        timer_arm(task, timeout_ms);
+    }
+}
+
+void sched_post(uint32_t events) {
+    uint32_t irq = save_and_disable_interrupts();
+    posted |= events;
+    restore_interrupts(irq);
+}
+
+/**
+ * @brief Revisa las ranuras de los milisegundos transcurridos desde la última vez
+ */
+static void timers_advance(uint32_t now) {
+    if (now - wheel_ms > SCHED_WHEEL_SLOTS) {
+        // Pasó más de una vuelta: basta con revisar cada ranura una vez
+        wheel_ms = now - SCHED_WHEEL_SLOTS;
+    }
+    while (wheel_ms != now) {
+        wheel_ms++;
+        uint32_t slot = wheel_ms & SCHED_WHEEL_MASK;
+        uint32_t bits = wheel[slot];
+        while (bits) {
+            uint32_t id = (uint32_t)__builtin_ctz(bits);
+            bits &= bits - 1;
+            sched_task_t *task = tasks[id];
+            if ((int32_t)(task->wake_ms - now) <= 0) {
+                wheel[slot] &= (uint16_t)~(1u << id);
+                task->events = 0;
+                task->state = SCHED_READY;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Despierta a las tareas que esperan alguno de los eventos publicados
+ */
+static void events_deliver(void) {
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t events = posted;
+    posted = 0;
+    restore_interrupts(irq);
+
+    if (events == 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < task_count; i++) {
+        sched_task_t *task = tasks[i];
+        if (task->state == SCHED_WAITING && (task->wait_mask & events)) {
+            timer_cancel(task);
+            task->events = task->wait_mask & events;
+            task->state = SCHED_READY;
+        }
+    }
+}
+
+uint32_t sched_step(void) {
+    uint32_t ran = 0;
+
+    timers_advance(now_ms());
+    events_deliver();
+    for (uint32_t i = 0; i < task_count; i++) {
+        sched_task_t *task = tasks[i];
+        if (task->state == SCHED_READY) {
+            task->fn(task);
+            ran++;
+        }
+    }
+    return ran;
+}
+
+static bool any_ready(void) {
+    for (uint32_t i = 0; i < task_count; i++) {
+        if (tasks[i]->state == SCHED_READY) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#if PICO_ON_DEVICE
+/**
+ * @brief Milisegundos desde wheel_ms hasta el próximo vencimiento
+ *
+ * Recorre la rueda hacia adelante; si no hay nada en una vuelta devuelve
+ * SCHED_WHEEL_SLOTS y el planificador vuelve a mirar al despertar.
+ */
+static uint32_t next_deadline(void) {
+    for (uint32_t d = 1; d < SCHED_WHEEL_SLOTS; d++) {
+        uint32_t bits = wheel[(wheel_ms + d) & SCHED_WHEEL_MASK];
+        while (bits) {
+            uint32_t id = (uint32_t)__builtin_ctz(bits);
+            bits &= bits - 1;
+            if ((int32_t)(tasks[id]->wake_ms - (wheel_ms + d)) <= 0) {
+                return d;
+            }
+        }
+    }
+    return SCHED_WHEEL_SLOTS;
+}
+#endif
+
+/**
+ * @brief Duerme la CPU hasta la próxima interrupción o vencimiento
+ *
+ * En el PC (PICO_PLATFORM=host) no hay __wfi() y simplemente se vuelve a
+ * mirar el reloj.
+ */
+static void sched_idle(void) {
+#if PICO_ON_DEVICE
+    if (now_ms() != wheel_ms) {
+        return; // Ya vencieron temporizadores sin revisar
+    }
+    uint64_t now_us = time_us_64();
+    uint64_t target_us = now_us - now_us % 1000 + (uint64_t)next_deadline() * 1000;
+
+    // Con las interrupciones deshabilitadas un evento no puede colarse entre
+    // la revisión y __wfi(); la interrupción pendiente igual despierta a la CPU
+    uint32_t irq = save_and_disable_interrupts();
+    if (!posted && !hardware_alarm_set_target(SCHED_ALARM_NUM, from_us_since_boot(target_us))) {
+        __wfi();
+    }
+    restore_interrupts(irq);
+#endif
+}
+
+void sched_run(void) {
+    while (true) {
+        sched_step();
+        if (!any_ready()) {
+            sched_idle();
+        }
+    }
+}
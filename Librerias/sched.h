@@ -0,0 +1,142 @@
+/**
+ * @file sched.h
+ * @brief Planificador cooperativo de tareas al estilo protothreads
+ *
+ * Cada tarea es una función que se ejecuta hasta llegar a un punto de espera
+ * (TASK_SLEEP, TASK_WAIT, TASK_YIELD) y retorna; en la siguiente ejecución
+ * continúa después de ese punto gracias a un switch sobre el número de línea.
+ * Así la medición, los LEDs, el pulsador y el GPS avanzan a la vez sin
+ * bloquearse con sleep_ms(). Las esperas por tiempo usan una rueda de
+ * temporizadores de SCHED_WHEEL_SLOTS ranuras de 1 ms y las esperas por
+ * evento usan una máscara de bits que se puede activar desde interrupciones.
+ * Cuando no hay ninguna tarea lista la CPU duerme con __wfi() hasta la
+ * próxima interrupción o el próximo vencimiento.
+ *
+ * Como en todo protothread, las variables locales no sobreviven a un punto de
+ * espera: lo que deba conservarse se declara static o se guarda en la tarea.
+ * Tampoco se puede esperar dentro de un switch propio de la tarea.
+ */
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SCHED_MAX_TASKS 16      ///< Tareas máximas (una por bit de la rueda)
+#define SCHED_WHEEL_SLOTS 64    ///< Ranuras de la rueda de temporizadores (potencia de 2)
+#define SCHED_FOREVER 0         ///< Espera de evento sin tiempo límite
+
+typedef struct sched_task sched_task_t;
+
+/**
+ * @brief Cuerpo de una tarea
+ *
+ * @param task La propia tarea, para usar las macros TASK_*
+ */
+typedef void (*sched_fn_t)(sched_task_t *task);
+
+/**
+ * @brief Estado de una tarea
+ */
+typedef enum {
+    SCHED_READY = 0,   ///< Lista para ejecutarse
+    SCHED_SLEEPING,    ///< Esperando un tiempo
+    SCHED_WAITING,     ///< Esperando un evento (con o sin tiempo límite)
+    SCHED_DONE         ///< Terminó (llegó a TASK_END)
+} sched_state_t;
+
+/**
+ * @brief Tarea del planificador
+ *
+ * La reserva el llamador (normalmente static) y la registra con sched_add().
+ */
+struct sched_task {
+    sched_fn_t fn;         ///< Cuerpo de la tarea
+    uint16_t line;         ///< Punto de continuación (0 = inicio)
+    uint8_t id;            ///< Índice en el planificador
+    uint8_t state;         ///< sched_state_t
+    uint32_t wake_ms;      ///< Vencimiento de la espera actual
+    uint32_t wait_mask;    ///< Eventos que la despiertan
+    uint32_t events;       ///< Eventos que la despertaron (0 si venció el tiempo)
+};
+
+/**
+ * @brief Inicio del cuerpo de una tarea
+ */
+#define TASK_BEGIN(t) switch ((t)->line) { case 0:
+
+/**
+ * @brief Fin del cuerpo de una tarea: la tarea queda terminada
+ */
+#define TASK_END(t) } (t)->line = 0; (t)->state = SCHED_DONE; return
+
+/**
+ * @brief Cede la CPU y continúa en la siguiente vuelta del planificador
+ */
+#define TASK_YIELD(t) \
+    do { (t)->line = __LINE__; return; case __LINE__:; } while (0)
+
+/**
+ * @brief Duerme la tarea ms milisegundos sin detener a las demás
+ */
+#define TASK_SLEEP(t, ms) \
+    do { sched_sleep((t), (ms)); (t)->line = __LINE__; return; case __LINE__:; } while (0)
+
+/**
+ * @brief Espera cualquiera de los eventos de mask, o hasta timeout_ms
+ *
+ * Al continuar, (t)->events tiene los eventos recibidos, o 0 si venció el
+ * tiempo. Con SCHED_FOREVER no hay tiempo límite.
+ */
+#define TASK_WAIT(t, mask, timeout_ms) \
+    do { sched_wait((t), (mask), (timeout_ms)); (t)->line = __LINE__; return; case __LINE__:; } while (0)
+
+/**
+ * @brief Inicializa el planificador
+ */
+void sched_init(void);
+
+/**
+ * @brief Registra una tarea; empieza lista para ejecutarse
+ *
+ * @param task Tarea (debe vivir mientras corra el planificador)
+ * @param fn Cuerpo de la tarea
+ * @return true si se registró, false si ya hay SCHED_MAX_TASKS tareas
+ */
+bool sched_add(sched_task_t *task, sched_fn_t fn);
+
+/**
+ * @brief Programa una espera por tiempo (usar TASK_SLEEP)
+ */
+void sched_sleep(sched_task_t *task, uint32_t ms);
+
+/**
+ * @brief Programa una espera por evento (usar TASK_WAIT)
+ */
+void sched_wait(sched_task_t *task, uint32_t mask, uint32_t timeout_ms);
+
+/**
+ * @brief Publica eventos para las tareas que los esperan
+ *
+ * Se puede llamar desde interrupciones. Los eventos que ninguna tarea está
+ * esperando en ese momento se descartan.
+ *
+ * @param events Máscara de eventos
+ */
+void sched_post(uint32_t events);
+
+/**
+ * @brief Ejecuta una vuelta: vence temporizadores, reparte eventos y corre
+ *        una vez cada tarea lista
+ *
+ * @return Número de tareas que se ejecutaron
+ */
+uint32_t sched_step(void);
+
+/**
+ * @brief Corre el planificador para siempre, durmiendo la CPU sin tareas listas
+ */
+void sched_run(void);
+
+#endif // SCHED_H
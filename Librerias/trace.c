@@ -0,0 +1,121 @@
+/**
+ * @file trace.c
+ * @brief Implementación de la grabación de trazas
+ *
+ * Los bytes del GPS se juntan en un buffer pequeño desde el bucle principal.
+ * Los bloques del ADC llegan desde la interrupción del DMA y pasan por una
+ * cola de un productor y un consumidor, así la interrupción nunca escribe en
+ * la memoria.
+ */
+
+#include "trace.h"
+#include "adc.h"
+#include "memory.h"
+#include "pico/stdlib.h"
+
+#define TRACE_UART_MAX_AGE_US 10000 ///< Tiempo máximo que un byte del GPS espera en el buffer
+
+/**
+ * @brief Bloque del ADC en cola
+ */
+typedef struct {
+    trace_record_t record;
+    uint16_t samples[ADC_BLOCK_SAMPLES * ADC_MAX_CHANNELS];
+} trace_slot_t;
+
+static volatile bool active;
+static uint32_t start_us;
+
+static uint8_t uart_buffer[TRACE_UART_CHUNK];
+static uint16_t uart_length;
+static uint32_t uart_timestamp;
+
+static trace_slot_t slots[TRACE_ADC_SLOTS];
+static volatile uint32_t slot_head; ///< Escrito solo por la interrupción
+static volatile uint32_t slot_tail; ///< Escrito solo por el bucle principal
+static volatile uint32_t dropped;
+
+/**
+ * @brief Guarda los bytes del GPS acumulados
+ */
+static void trace_flush_uart(void) {
+    if (uart_length == 0) {
+        return;
+    }
+    trace_record_t record = { TRACE_UART, 0, uart_length, uart_timestamp };
+    memory_write_bytes((const uint8_t *)&record, sizeof(record));
+    memory_write_bytes(uart_buffer, uart_length);
+    uart_length = 0;
+}
+
+void trace_start(uint32_t sample_rate, uint8_t channels) {
+    trace_header_t header = { TRACE_MAGIC, TRACE_VERSION, channels, sample_rate };
+    memory_write_bytes((const uint8_t *)&header, sizeof(header));
+    uart_length = 0;
+    slot_head = 0;
+    slot_tail = 0;
+    dropped = 0;
+    start_us = time_us_32();
+    active = true;
+}
+
+void trace_stop(void) {
+    trace_task();
+    active = false;
+    trace_flush_uart();
+}
+
+void trace_uart_byte(uint8_t c) {
+    if (!active) {
+        return;
+    }
+    if (uart_length == 0) {
+        uart_timestamp = time_us_32() - start_us;
+    }
+    uart_buffer[uart_length++] = c;
+    if (c == '\n' || uart_length == TRACE_UART_CHUNK) {
+        trace_flush_uart();
+    }
+}
+
+void trace_adc_block(const uint16_t *block, uint16_t count) {
+    if (!active) {
+        return;
+    }
+    uint32_t head = slot_head;
+    if (head - slot_tail >= TRACE_ADC_SLOTS) {
+        dropped++;
+        return;
+    }
+    if (count > ADC_BLOCK_SAMPLES * ADC_MAX_CHANNELS) {
+        count = ADC_BLOCK_SAMPLES * ADC_MAX_CHANNELS;
+    }
+
+    trace_slot_t *slot = &slots[head % TRACE_ADC_SLOTS];
+    slot->record.type = TRACE_ADC;
+    slot->record.reserved = 0;
+    slot->record.length = count * sizeof(uint16_t);
+    slot->record.timestamp_us = time_us_32() - start_us;
+    for (uint16_t i = 0; i < count; i++) {
+        slot->samples[i] = block[i];
+    }
+    slot_head = head + 1;
+}
+
+void trace_task(void) {
+    if (!active) {
+        return;
+    }
+    if (uart_length && time_us_32() - start_us - uart_timestamp > TRACE_UART_MAX_AGE_US) {
+        trace_flush_uart();
+    }
+    while (slot_tail != slot_head) {
+        trace_slot_t *slot = &slots[slot_tail % TRACE_ADC_SLOTS];
+        memory_write_bytes((const uint8_t *)slot, sizeof(slot->record) + slot->record.length);
+        slot_tail = slot_tail + 1;
+    }
+}
+
+uint32_t trace_dropped(void) {
+    return dropped;
+}
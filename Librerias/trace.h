@@ -0,0 +1,102 @@
+/**
+ * @file trace.h
+ * @brief Grabación de trazas del UART del GPS y de los bloques DMA del ADC
+ *
+ * Una traza empieza con un trace_header_t y sigue con registros
+ * trace_record_t, cada uno seguido de length bytes de datos. Los bytes del GPS
+ * se agrupan en registros TRACE_UART y cada bloque del DMA del ADC se guarda
+ * completo, tal como lo entrega el DMA (intercalado si hay varios micrófonos
+ * y con los bits de error), en un registro TRACE_ADC. Los tiempos son en
+ * microsegundos desde trace_start(). La herramienta Herramientas/replay.c
+ * reproduce estas trazas en el PC sobre el mismo código de análisis.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TRACE_MAGIC 0x52544D47u  ///< "GMTR" en little-endian
+#define TRACE_VERSION 2          ///< Versión del formato (la 1 no tenía channels y era de un canal)
+#define TRACE_UART_CHUNK 64      ///< Bytes máximos del GPS por registro
+#define TRACE_ADC_SLOTS 4        ///< Bloques del ADC que pueden esperar a ser guardados
+
+/**
+ * @brief Tipos de registro
+ */
+typedef enum {
+    TRACE_UART = 1, ///< Bytes recibidos del GPS
+    TRACE_ADC = 2   ///< Bloque crudo del DMA del ADC (uint16_t por muestra)
+} trace_type_t;
+
+/**
+ * @brief Encabezado de la traza
+ */
+typedef struct {
+    uint32_t magic;        ///< TRACE_MAGIC
+    uint16_t version;      ///< TRACE_VERSION
+    uint16_t channels;     ///< Micrófonos intercalados en cada bloque del ADC
+    uint32_t sample_rate;  ///< Frecuencia de muestreo de cada micrófono (Hz)
+} trace_header_t;
+
+/**
+ * @brief Encabezado de cada registro
+ */
+typedef struct {
+    uint8_t type;           ///< trace_type_t
+    uint8_t reserved;
+    uint16_t length;        ///< Bytes de datos que siguen al encabezado
+    uint32_t timestamp_us;  ///< Tiempo de captura desde trace_start() (da la vuelta cada ~71.6 min)
+} trace_record_t;
+
+/**
+ * @brief Empieza a grabar una traza en la memoria
+ *
+ * @param sample_rate Frecuencia de muestreo de cada micrófono
+ * @param channels Micrófonos que captura el DMA en round-robin
+ */
+void trace_start(uint32_t sample_rate, uint8_t channels);
+
+/**
+ * @brief Termina la traza guardando lo pendiente
+ */
+void trace_stop(void);
+
+/**
+ * @brief Registra un byte recibido del GPS
+ *
+ * No hace nada si no hay una traza activa, así que los lectores del GPS la
+ * llaman siempre.
+ *
+ * @param c Byte recibido
+ */
+void trace_uart_byte(uint8_t c);
+
+/**
+ * @brief Registra un bloque del DMA del ADC
+ *
+ * Se llama desde la interrupción del DMA, antes de separar los canales: solo
+ * copia el bloque a una cola fija. Si la cola está llena el bloque se
+ * descarta y se cuenta.
+ *
+ * @param block Muestras crudas del ADC, intercaladas si hay varios canales
+ * @param count Número total de muestras (como máximo ADC_BLOCK_SAMPLES * ADC_MAX_CHANNELS)
+ */
+void trace_adc_block(const uint16_t *block, uint16_t count);
+
+/**
+ * @brief Guarda en memoria los bloques del ADC en cola
+ *
+ * Debe llamarse desde el bucle principal.
+ */
+void trace_task(void);
+
+/**
+ * @brief Bloques del ADC descartados por cola llena
+ *
+ * @return Número de bloques perdidos en la traza
+ */
+uint32_t trace_dropped(void);
+
+#endif // TRACE_H
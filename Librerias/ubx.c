@@ -0,0 +1,462 @@
+/**
+ * @file ubx.c
+ * @brief Implementación del protocolo binario UBX para el NEO-6M
+ *
+ * Los mensajes se analizan byte a byte con una máquina de estados y se
+ * verifican con el checksum Fletcher de 8 bits del protocolo. Los payloads de
+ * navegación tienen posiciones fijas, así que se copian directo a ubx_nav_t
+ * sin pasar por texto.
+ *
+ * A UBX_BAUD_RATE la FIFO de 32 bytes del UART se llena en ~2.8 ms, menos que
+ * el período de la tarea del GPS. Por eso, una vez configurado el receptor,
+ * la interrupción de recepción del UART pasa los bytes a un anillo de
+ * UBX_RX_RING_BYTES y ubx_poll() los analiza desde ahí.
+ */
+
+#include "ubx.h"
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+#if PICO_ON_DEVICE
+#include "hardware/irq.h"
+#endif
+#include "trace.h"
+
+#define UBX_UART_ID uart1      ///< Mismo UART que usa gps.c
+#define UBX_SYNC_1 0xB5        ///< Primer byte de sincronización
+#define UBX_SYNC_2 0x62        ///< Segundo byte de sincronización
+#define UBX_DETECT_TIMEOUT_MS 300 ///< Espera por respuesta en cada velocidad probada
+#define UBX_ACK_TIMEOUT_MS 500    ///< Espera por ACK de un mensaje de configuración
+#define UBX_RX_RING_BYTES 1024    ///< ~89 ms a 115200 baudios sin llamar a ubx_poll()
+#define UBX_RX_RING_MASK (UBX_RX_RING_BYTES - 1)
+
+#define UBX_CLASS_NAV 0x01
+#define UBX_CLASS_ACK 0x05
+#define UBX_CLASS_CFG 0x06
+#define UBX_CLASS_NMEA 0xF0
+
+#define UBX_NAV_POSLLH 0x02
+#define UBX_NAV_STATUS 0x03
+#define UBX_NAV_PVT 0x07
+#define UBX_ACK_NAK 0x00
+#define UBX_ACK_ACK 0x01
+#define UBX_CFG_PRT 0x00
+#define UBX_CFG_MSG 0x01
+#define UBX_CFG_RATE 0x08
+
+/**
+ * @brief Estados del analizador de tramas
+ */
+typedef enum {
+    UBX_WAIT_SYNC_1,
+    UBX_WAIT_SYNC_2,
+    UBX_WAIT_CLASS,
+    UBX_WAIT_ID,
+    UBX_WAIT_LEN_1,
+    UBX_WAIT_LEN_2,
+    UBX_WAIT_PAYLOAD,
+    UBX_WAIT_CK_A,
+    UBX_WAIT_CK_B
+} ubx_state_t;
+
+/**
+ * @brief Analizador de tramas UBX
+ */
+typedef struct {
+    ubx_state_t state;
+    uint8_t cls;
+    uint8_t id;
+    uint16_t len;
+    uint16_t pos;
+    uint8_t ck_a;
+    uint8_t ck_b;
+    uint8_t payload[UBX_MAX_PAYLOAD];
+} ubx_parser_t;
+
+static ubx_parser_t parser;
+static uint32_t checksum_errors;
+static uint8_t nav_fix_type;  ///< Último gpsFix de NAV-STATUS
+static bool nav_fix_ok;       ///< Último gpsFixOk de NAV-STATUS
+
+static uint8_t rx_ring[UBX_RX_RING_BYTES]; ///< Bytes recibidos por la interrupción
+static volatile uint32_t rx_head;           ///< Bytes escritos por la interrupción
+static volatile uint32_t rx_tail;           ///< Bytes leídos por ubx_poll()
+static volatile uint32_t rx_overruns;       ///< Bytes perdidos por anillo lleno
+
+_Static_assert((UBX_RX_RING_BYTES & UBX_RX_RING_MASK) == 0, "UBX_RX_RING_BYTES debe ser potencia de 2");
+
+static const uint32_t baud_rates[] = { 9600, 115200, 38400, 57600, 19200, 4800 };
+
+static inline uint16_t get_u2(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u4(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void put_u2(uint8_t *p, uint16_t value) {
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+static inline void put_u4(uint8_t *p, uint32_t value) {
+    put_u2(p, value & 0xFFFF);
+    put_u2(p + 2, value >> 16);
+}
+
+/**
+ * @brief Procesa un byte recibido
+ *
+ * @return true cuando se completa una trama con checksum válido
+ */
+static bool ubx_parse_byte(ubx_parser_t *p, uint8_t c) {
+    switch (p->state) {
+    case UBX_WAIT_SYNC_1:
+        if (c == UBX_SYNC_1) {
+            p->state = UBX_WAIT_SYNC_2;
+        }
+        return false;
+    case UBX_WAIT_SYNC_2:
+        p->state = (c == UBX_SYNC_2) ? UBX_WAIT_CLASS : UBX_WAIT_SYNC_1;
+        return false;
+    case UBX_WAIT_CLASS:
+        p->cls = c;
+        p->ck_a = c;
+        p->ck_b = c;
+        p->state = UBX_WAIT_ID;
+        return false;
+    case UBX_WAIT_ID:
+        p->id = c;
+        p->state = UBX_WAIT_LEN_1;
+        break;
+    case UBX_WAIT_LEN_1:
+        p->len = c;
+        p->state = UBX_WAIT_LEN_2;
+        break;
+    case UBX_WAIT_LEN_2:
+        p->len |= (uint16_t)c << 8;
+        p->pos = 0;
+        p->state = p->len ? UBX_WAIT_PAYLOAD : UBX_WAIT_CK_A;
+        break;
+    case UBX_WAIT_PAYLOAD:
+        // Los payloads más largos que el buffer se recorren pero no se guardan
+        if (p->pos < UBX_MAX_PAYLOAD) {
+            p->payload[p->pos] = c;
+        }
+        if (++p->pos == p->len) {
+            p->state = UBX_WAIT_CK_A;
+        }
+        break;
+    case UBX_WAIT_CK_A:
+        p->state = (c == p->ck_a) ? UBX_WAIT_CK_B : UBX_WAIT_SYNC_1;
+        if (p->state == UBX_WAIT_SYNC_1) {
+            checksum_errors++;
+        }
+        return false;
+    case UBX_WAIT_CK_B:
+        p->state = UBX_WAIT_SYNC_1;
+        if (c != p->ck_b) {
+            checksum_errors++;
+            return false;
+        }
+        return p->len <= UBX_MAX_PAYLOAD;
+    }
+
+    // Checksum Fletcher de 8 bits sobre clase, id, longitud y payload
+    p->ck_a += c;
+    p->ck_b += p->ck_a;
+    return false;
+}
+
+/**
+ * @brief Envía una trama UBX
+ */
+static void ubx_send(uint8_t cls, uint8_t id, const uint8_t *payload, uint16_t len) {
+    uint8_t header[6] = { UBX_SYNC_1, UBX_SYNC_2, cls, id, len & 0xFF, len >> 8 };
+    uint8_t ck_a = 0, ck_b = 0;
+
+    for (int i = 2; i < 6; i++) {
+        ck_a += header[i];
+        ck_b += ck_a;
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        ck_a += payload[i];
+        ck_b += ck_a;
+    }
+
+    uint8_t checksum[2] = { ck_a, ck_b };
+    uart_write_blocking(UBX_UART_ID, header, sizeof(header));
+    if (len) {
+        uart_write_blocking(UBX_UART_ID, payload, len);
+    }
+    uart_write_blocking(UBX_UART_ID, checksum, sizeof(checksum));
+}
+
+/**
+ * @brief Espera la respuesta a un mensaje enviado
+ *
+ * Acepta un ACK-ACK del mensaje o una trama de la misma clase e id (respuesta
+ * a un poll).
+ *
+ * @return true si llegó la respuesta, false si hubo NAK o se agotó el tiempo
+ */
+static bool ubx_wait_reply(uint8_t cls, uint8_t id, uint32_t timeout_ms) {
+    uint64_t deadline = time_us_64() + (uint64_t)timeout_ms * 1000;
+    ubx_parser_t *p = &parser;
+
+    while (time_us_64() < deadline) {
+        if (!uart_is_readable(UBX_UART_ID)) {
+            continue;
+        }
+        if (!ubx_parse_byte(p, (uint8_t)uart_getc(UBX_UART_ID))) {
+            continue;
+        }
+        if (p->cls == UBX_CLASS_ACK && p->len == 2 && p->payload[0] == cls && p->payload[1] == id) {
+            return p->id == UBX_ACK_ACK;
+        }
+        if (p->cls == cls && p->id == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Descarta los bytes pendientes del UART
+ */
+static void ubx_drain(void) {
+    while (uart_is_readable(UBX_UART_ID)) {
+        uart_getc(UBX_UART_ID);
+    }
+    parser.state = UBX_WAIT_SYNC_1;
+}
+
+/**
+ * @brief Pregunta la configuración del puerto para saber si el receptor responde
+ */
+static bool ubx_probe(void) {
+    uint8_t port = 1; // UART1 del receptor
+    ubx_drain();
+    ubx_send(UBX_CLASS_CFG, UBX_CFG_PRT, &port, 1);
+    return ubx_wait_reply(UBX_CLASS_CFG, UBX_CFG_PRT, UBX_DETECT_TIMEOUT_MS);
+}
+
+/**
+ * @brief Prueba las velocidades habituales hasta que el receptor responda
+ *
+ * @return Velocidad detectada o 0 si no hubo respuesta
+ */
+static uint32_t ubx_detect_baud(void) {
+    for (size_t i = 0; i < sizeof(baud_rates) / sizeof(baud_rates[0]); i++) {
+        uart_set_baudrate(UBX_UART_ID, baud_rates[i]);
+        if (ubx_probe()) {
+            return baud_rates[i];
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Configura el puerto del receptor a 8N1 con la velocidad dada
+ *
+ * @param baud Nueva velocidad
+ * @param out_nmea true para seguir enviando NMEA además de UBX
+ */
+static void ubx_set_port(uint32_t baud, bool out_nmea) {
+    uint8_t payload[20] = { 0 };
+    payload[0] = 1;                          // portID: UART1
+    put_u4(&payload[4], 0x000008D0);         // mode: 8 bits, sin paridad, 1 stop
+    put_u4(&payload[8], baud);
+    put_u2(&payload[12], 0x0003);            // inProtoMask: UBX + NMEA
+    put_u2(&payload[14], out_nmea ? 0x0003 : 0x0001);
+    ubx_send(UBX_CLASS_CFG, UBX_CFG_PRT, payload, sizeof(payload));
+    uart_tx_wait_blocking(UBX_UART_ID);
+    sleep_ms(100);
+}
+
+/**
+ * @brief Cambia la tasa de un mensaje en el puerto actual
+ */
+static bool ubx_set_msg_rate(uint8_t cls, uint8_t id, uint8_t rate) {
+    uint8_t payload[3] = { cls, id, rate };
+    ubx_send(UBX_CLASS_CFG, UBX_CFG_MSG, payload, sizeof(payload));
+    return ubx_wait_reply(UBX_CLASS_CFG, UBX_CFG_MSG, UBX_ACK_TIMEOUT_MS);
+}
+
+/**
+ * @brief Cambia el período de navegación del receptor
+ *
+ * @param period_ms measRate en milisegundos
+ */
+static void ubx_set_nav_period(uint16_t period_ms) {
+    uint8_t rate[6];
+    put_u2(&rate[0], period_ms); // measRate (ms)
+    put_u2(&rate[2], 1);         // navRate
+    put_u2(&rate[4], 1);         // timeRef: tiempo GPS
+    ubx_send(UBX_CLASS_CFG, UBX_CFG_RATE, rate, sizeof(rate));
+    ubx_wait_reply(UBX_CLASS_CFG, UBX_CFG_RATE, UBX_ACK_TIMEOUT_MS);
+}
+
+/**
+ * @brief Deja el receptor como lo lee gps.c cuando no se puede usar UBX
+ *
+ * Vuelve a activar GGA, restaura el período de navegación y la velocidad
+ * detectada al inicio. gps_poll() no usa el anillo de la interrupción y a
+ * 115200 baudios la FIFO del UART se llenaría entre dos lecturas.
+ *
+ * @param baud Velocidad detectada al inicio
+ * @param period_ms Período de navegación anterior a ubx_init()
+ */
+static void ubx_restore_nmea(uint32_t baud, uint16_t period_ms) {
+    ubx_set_msg_rate(UBX_CLASS_NMEA, 0x00, 1);
+    ubx_set_nav_period(period_ms);
+    ubx_set_port(baud, true);
+    uart_set_baudrate(UBX_UART_ID, baud);
+    ubx_drain();
+}
+
+/**
+ * @brief Pasa al anillo los bytes de la FIFO del UART
+ *
+ * Es la interrupción de recepción del UART en la placa; en el PC la llama
+ * ubx_poll() directamente.
+ */
+static void ubx_uart_rx(void) {
+    while (uart_is_readable(UBX_UART_ID)) {
+        uint8_t c = (uint8_t)uart_getc(UBX_UART_ID);
+        uint32_t head = rx_head;
+        if (head - rx_tail < UBX_RX_RING_BYTES) {
+            rx_ring[head & UBX_RX_RING_MASK] = c;
+            rx_head = head + 1;
+        } else {
+            rx_overruns++;
+        }
+    }
+}
+
+/**
+ * @brief Activa la interrupción de recepción del UART
+ */
+static void ubx_rx_irq_start(void) {
+    rx_head = 0;
+    rx_tail = 0;
+#if PICO_ON_DEVICE
+    int irq = UBX_UART_ID == uart0 ? UART0_IRQ : UART1_IRQ;
+    irq_set_exclusive_handler(irq, ubx_uart_rx);
+    irq_set_enabled(irq, true);
+    uart_set_irq_enables(UBX_UART_ID, true, false);
+#endif
+}
+
+bool ubx_init(uint8_t rate_hz) {
+    if (rate_hz < 1) {
+        rate_hz = 1;
+    }
+    if (rate_hz > UBX_MAX_RATE_HZ) {
+        rate_hz = UBX_MAX_RATE_HZ;
+    }
+
+    uint32_t detected = ubx_detect_baud();
+    if (detected == 0) {
+        return false;
+    }
+
+    if (detected != UBX_BAUD_RATE) {
+        ubx_set_port(UBX_BAUD_RATE, true);
+        uart_set_baudrate(UBX_UART_ID, UBX_BAUD_RATE);
+        if (!ubx_probe()) {
+            // El receptor no cambió: se vuelve a la velocidad anterior con NMEA
+            uart_set_baudrate(UBX_UART_ID, detected);
+            return false;
+        }
+    }
+
+    // Período actual, para restaurarlo si no se puede quedar en UBX (1 s por defecto)
+    uint16_t old_period_ms = 1000;
+    ubx_send(UBX_CLASS_CFG, UBX_CFG_RATE, NULL, 0);
+    if (ubx_wait_reply(UBX_CLASS_CFG, UBX_CFG_RATE, UBX_ACK_TIMEOUT_MS) && parser.cls == UBX_CLASS_CFG && parser.len == 6) {
+        old_period_ms = get_u2(parser.payload);
+    }
+
+    // Sentencias NMEA estándar: GGA, GLL, GSA, GSV, RMC y VTG
+    for (uint8_t id = 0x00; id <= 0x05; id++) {
+        ubx_set_msg_rate(UBX_CLASS_NMEA, id, 0);
+    }
+    ubx_set_nav_period(1000 / rate_hz);
+
+    // NAV-PVT no existe en el NEO-6M (responde NAK); se usa POSLLH + STATUS
+    bool pvt = ubx_set_msg_rate(UBX_CLASS_NAV, UBX_NAV_PVT, 1);
+    bool llh = !pvt && ubx_set_msg_rate(UBX_CLASS_NAV, UBX_NAV_POSLLH, 1);
+    bool status = !pvt && ubx_set_msg_rate(UBX_CLASS_NAV, UBX_NAV_STATUS, 1);
+
+    if (!pvt && !(llh && status)) {
+        // Sin mensajes de navegación se vuelve a NMEA como estaba antes
+        ubx_restore_nmea(detected, old_period_ms);
+        return false;
+    }
+
+    ubx_set_port(UBX_BAUD_RATE, false);
+    ubx_drain();
+    ubx_rx_irq_start();
+    return true;
+}
+
+bool ubx_poll(ubx_nav_t *nav) {
+    bool updated = false;
+
+#if !PICO_ON_DEVICE
+    ubx_uart_rx();
+#endif
+    uint32_t tail = rx_tail;
+    while (tail != rx_head) {
+        uint8_t c = rx_ring[tail & UBX_RX_RING_MASK];
+        rx_tail = ++tail;
+        trace_uart_byte(c);
+        updated |= ubx_feed(c, nav);
+    }
+
+    return updated;
+}
+
+bool ubx_feed(uint8_t c, ubx_nav_t *nav) {
+    ubx_parser_t *p = &parser;
+
+    if (!ubx_parse_byte(p, c) || p->cls != UBX_CLASS_NAV) {
+        return false;
+    }
+
+    const uint8_t *m = p->payload;
+    if (p->id == UBX_NAV_STATUS && p->len == 16) {
+        nav_fix_type = m[4];
+        nav_fix_ok = m[5] & 0x01;
+    } else if (p->id == UBX_NAV_POSLLH && p->len == 28) {
+        nav->itow = get_u4(&m[0]);
+        nav->lon_e7 = (int32_t)get_u4(&m[4]);
+        nav->lat_e7 = (int32_t)get_u4(&m[8]);
+        nav->height_mm = (int32_t)get_u4(&m[16]);
+        nav->hacc_mm = get_u4(&m[20]);
+        nav->fix_type = nav_fix_type;
+        nav->num_sv = 0;
+        nav->fix_ok = nav_fix_ok && nav_fix_type >= 2;
+        return nav->fix_ok;
+    } else if (p->id == UBX_NAV_PVT && p->len == 92) {
+        nav->itow = get_u4(&m[0]);
+        nav->fix_type = m[20];
+        nav->fix_ok = (m[21] & 0x01) && m[20] >= 2;
+        nav->num_sv = m[23];
+        nav->lon_e7 = (int32_t)get_u4(&m[24]);
+        nav->lat_e7 = (int32_t)get_u4(&m[28]);
+        nav->height_mm = (int32_t)get_u4(&m[36]);
+        nav->hacc_mm = get_u4(&m[40]);
+        return nav->fix_ok;
+    }
+    return false;
+}
+
+uint32_t ubx_checksum_errors(void) {
+    return checksum_errors;
+}
+
+uint32_t ubx_rx_overruns(void) {
+    return rx_overruns;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file ubx.h
+ * @brief Protocolo binario UBX para el NEO-6M
+ *
+ * Detecta la velocidad actual del receptor, lo pasa a una velocidad mayor,
+ * apaga las sentencias NMEA y habilita los mensajes binarios de navegación
+ * (NAV-POSLLH/NAV-STATUS en el NEO-6M, NAV-PVT en receptores más nuevos) a
+ * hasta 5 Hz. Si el receptor no responde en UBX se sigue usando NMEA con
+ * gps_poll().
+ */
+
+#ifndef UBX_H
+#define UBX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define UBX_BAUD_RATE 115200   ///< Velocidad a la que se configura el receptor
+#define UBX_MAX_RATE_HZ 5      ///< Tasa máxima de navegación soportada por el NEO-6M
+#define UBX_MAX_PAYLOAD 100    ///< Payload más largo que se analiza (NAV-PVT ocupa 92 bytes)
+#define UBX_LEAP_SECONDS 18    ///< Diferencia entre la hora GPS y UTC (desde 2017)
+
+/**
+ * @brief Solución de navegación decodificada de NAV-PVT o NAV-POSLLH
+ */
+typedef struct {
+    uint32_t itow;      ///< Tiempo de la semana GPS (ms)
+    int32_t lat_e7;     ///< Latitud en 1e-7 grados
+    int32_t lon_e7;     ///< Longitud en 1e-7 grados
+    int32_t height_mm;  ///< Altura sobre el nivel del mar (mm)
+    uint32_t hacc_mm;   ///< Precisión horizontal estimada (mm)
+    uint8_t fix_type;   ///< 0 sin fix, 2 fix 2D, 3 fix 3D
+    uint8_t num_sv;     ///< Satélites usados (solo NAV-PVT, 0 si no se conoce)
+    bool fix_ok;        ///< true si el receptor marca la solución como válida
+} ubx_nav_t;
+
+/**
+ * @brief Configura el receptor en modo UBX
+ *
+ * Prueba las velocidades habituales hasta recibir respuesta, cambia el puerto
+ * a UBX_BAUD_RATE, desactiva las sentencias NMEA y habilita los mensajes de
+ * navegación a la tasa indicada. Bloquea unos segundos como máximo, por lo
+ * que debe llamarse al iniciar, después de gps_init().
+ *
+ * @param rate_hz Tasa de navegación en Hz (1 a UBX_MAX_RATE_HZ)
+ * Si el receptor no entrega mensajes de navegación UBX se deja como estaba:
+ * GGA activo, el período de navegación anterior y la velocidad detectada.
+ *
+ * @return true si el receptor quedó en UBX, false si se debe seguir con NMEA
+ */
+bool ubx_init(uint8_t rate_hz);
+
+/**
+ * @brief Lee sin bloquear los mensajes UBX disponibles
+ *
+ * Analiza los bytes que la interrupción del UART dejó en el anillo desde la
+ * llamada anterior. Debe llamarse al menos cada ~89 ms para no perder bytes.
+ *
+ * @param nav Solución que se actualiza cuando llega una nueva posición con fix
+ * @return true si hay una nueva posición válida, false en caso contrario
+ */
+bool ubx_poll(ubx_nav_t *nav);
+
+/**
+ * @brief Procesa un byte UBX recibido
+ *
+ * No accede al UART, por lo que también sirve para reproducir trazas
+ * grabadas en el PC.
+ *
+ * @param c Byte recibido
+ * @param nav Solución que se actualiza cuando llega una nueva posición con fix
+ * @return true si el byte completó una nueva posición válida
+ */
+bool ubx_feed(uint8_t c, ubx_nav_t *nav);
+
+/**
+ * @brief Mensajes descartados por checksum inválido desde el inicio
+ *
+ * @return Número de errores de checksum
+ */
+uint32_t ubx_checksum_errors(void);
+
+/**
+ * @brief Bytes recibidos que se perdieron por no llamar a tiempo a ubx_poll()
+ *
+ * @return Número de bytes descartados con el anillo de recepción lleno
+ */
+uint32_t ubx_rx_overruns(void);
+
+/**
+ * @brief Pasa una coordenada de 1e-7 grados a micro-grados, redondeando
+ *
+ * @param e7 Coordenada en 1e-7 grados
+ * @return Coordenada en micro-grados
+ */
+static inline int32_t ubx_e7_to_e6(int32_t e7) {
+    return e7 >= 0 ? (e7 + 5) / 10 : (e7 - 5) / 10;
+}
+
+/**
+ * @brief Hora UTC del día a partir del tiempo de la semana GPS
+ *
+ * @param itow Tiempo de la semana GPS (ms)
+ * @return Milisegundos desde la medianoche UTC
+ */
+static inline uint32_t ubx_time_of_day_ms(uint32_t itow) {
+    const uint32_t week_ms = 7u * 86400000u;
+    return (itow + week_ms - UBX_LEAP_SECONDS * 1000u) % 86400000u;
+}
+
+#endif // UBX_H
@@ -12,44 +12,48 @@
  */
 
 #include <stdio.h>
-#include <math.h>
 #include "pico/stdlib.h"
 #include "hardware/dma.h"
 #include "hardware/adc.h"
 #include "hardware/pwm.h"
 #include "hardware/sync.h"
 #include "hardware/resets.h"
+#include "kernels.h"
+#include "fmt.h"
 
 #define ADC_DMA_CH 5    ///< Canal DMA utilizado para ADC
 #define ADC_CH     0    ///< Canal ADC utilizado para el micrófono (GPIO26)
-#define ADC_CONVERT (3.3 / ((1<<12)-1)) ///< Conversión de ADC a voltaje
+#define ADC_CONVERT_UV 3300000       ///< Fondo de escala del ADC en microvoltios
+#define ADC_FULL_SCALE ((1<<12)-1)   ///< Cuenta máxima del ADC
+#define NOISE_REF_CDB 6708           ///< 20 * log10(2260 uV) en centésimas de dB (0 dB = 0.00226 V)
 
 int16_t buffer[100];  ///< Buffer para almacenar los datos del ADC
 
 volatile bool gFlagDMA = false; ///< Indicador de finalización del DMA
-float noise = 0; ///< Variable para almacenar el nivel de ruido
+uint32_t noise = 0; ///< Variable para almacenar el nivel de ruido (microvoltios)
 
 /**
  * @brief Interrupción del DMA
  * 
  * Se llama cuando el DMA completa la transferencia de datos del ADC.
  * Calcula el voltaje promedio del micrófono y lo convierte a decibelios.
+ * La suma y el conteo de errores se hacen con enteros en kernel_block_stats(),
+ * y el voltaje y los dB se calculan y se escriben sin punto flotante. Los dB
+ * se escriben con 2 decimales, que es su resolución, en lugar de los 6 del
+ * "%f" original.
  */
 void isrDMA_IRQ0(void) {
     dma_irqn_acknowledge_channel(0, ADC_DMA_CH);
     adc_run(false);
-    uint16_t cnt = 0;
-    noise = 0;
-    for (int i = 0; i < 100; i++) {
-        if (!(buffer[i] & (1 << 15))) {
-            cnt++;
-            noise += (float)buffer[i];
-        }
-    }
-    noise /= cnt;
-    noise *= ADC_CONVERT;
-    float avg_noise_db = 20 * log10(noise / 0.00226);
-    printf("AvgVolt: %f\tAvgNoisedB: %f\tErrors: %d\n", noise, avg_noise_db, 100 - cnt);
+    block_stats_t stats;
+    kernel_block_stats((const uint16_t *)buffer, 100, &stats);
+    noise = stats.valid ? (uint32_t)((uint64_t)stats.sum * ADC_CONVERT_UV / ((uint64_t)ADC_FULL_SCALE * stats.valid)) : 0;
+    int32_t avg_noise_cdb = kernel_power_cdb((uint64_t)noise * noise) - NOISE_REF_CDB;
+
+    char volt_text[24], db_text[24];
+    fmt_fixed(volt_text, (int32_t)noise, 6, 6);
+    fmt_fixed(db_text, avg_noise_cdb, 2, 2);
+    printf("AvgVolt: %s\tAvgNoisedB: %s\tErrors: %d\n", volt_text, db_text, stats.errors);
     gFlagDMA = true;
     pwm_set_enabled(0, false);
 }
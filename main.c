@@ -14,6 +14,17 @@
 #include "memory.h"
 #include "led.h"
 #include "button.h"
+#include "monitor.h"
+#include "ubx.h"
+#include "trace.h"
+#include "mics.h"
+#include "fmt.h"
+#include "sched.h"
+#include "kernels.h"
+#include "classifier.h"
+#include "levels.h"
+#include "geofence.h"
+#include "geofence_data.h"
 
 
 #define LED_GREEN 2 //Se activa cuando el dispositivo se enciende y cuando 
@@ -23,15 +34,280 @@
                   // Parpadea si se pierde el GPS
 #define BUTTON_PIN 15
 
+#define MONITOR_THRESHOLD_DB 45.0f // Nivel que dispara la grabacion en modo continuo
+#define MONITOR_RISE_DB 10.0f      // Subida de nivel que dispara la grabacion en modo continuo
+#define MIC_COUNT 1                // Microfonos en GP26..GP28 para el modo continuo
+#define TRACE_MODE 0               // 1: graba una traza para Herramientas/replay.c en lugar de eventos
+
+#define BUTTON_POLL_MS 20          // Periodo de lectura del pulsador
+#define GPS_POLL_MS 10             // Periodo de lectura del GPS: en NMEA a 9600 baudios la FIFO del UART se llena en ~33 ms; en UBX a 115200 la interrupcion del UART junta los bytes en un anillo de ~89 ms
+#define MONITOR_POLL_MS 4          // Periodo de guardado de eventos en modo continuo
+#define MEASURE_MS 10000           // Duracion de la medicion manual
+
+// Eventos del planificador
+#define EV_BUTTON (1u << 0)        // Flanco de bajada del pulsador
+#define EV_FIX (1u << 1)           // Nueva posicion con fix
+#define EV_ABORT (1u << 2)         // Medicion cancelada: rojo por tres segundos
+#define EV_SAVED (1u << 3)         // Medicion guardada: naranja por medio segundo
+#define EV_LED_IDLE (1u << 4)      // Termino la indicacion de los LEDs
+
+static bool use_ubx;               // El GPS respondio a UBX en modo continuo
+static int32_t fix_latitude;       // Ultima posicion con fix, en micro-grados
+static int32_t fix_longitude;
+static uint16_t fix_zone = GEOFENCE_NO_ZONE; // Zona regulada de la ultima posicion
+static int32_t fix_limit_cdb;      // Limite vigente de esa zona, en centesimas de dB
+
+static volatile uint64_t measure_energy; // Energia AC de la medicion manual, en cuentas^2
+static volatile uint32_t measure_count;  // Muestras validas de la medicion manual
+static volatile uint32_t measure_sum;    // Suma de esas muestras, para el promedio crudo
+static levels_t measure_levels;          // Niveles cortos de la medicion manual, para L10/L50/L90
+static uint64_t level_energy;            // Energia AC del nivel corto en curso
+static uint32_t level_count;             // Muestras validas del nivel corto en curso
+static uint32_t level_blocks;            // Bloques del nivel corto en curso
+
+static sched_task_t button_task;
+static sched_task_t gps_task;
+static sched_task_t led_task;
+static sched_task_t measure_task;
+static sched_task_t monitor_task_handle;
+
+/**
+ * @brief Lee el pulsador y publica EV_BUTTON en cada pulsacion
+ */
+static void button_task_fn(sched_task_t *t) {
+    static bool was_pressed = true; // Si sigue oprimido desde el arranque no cuenta
+    TASK_BEGIN(t);
+    while (true) {
+        if (button_is_pressed()) {
+            if (!was_pressed) {
+                sched_post(EV_BUTTON);
+            }
+            was_pressed = true;
+        } else {
+            was_pressed = false;
+        }
+        TASK_SLEEP(t, BUTTON_POLL_MS);
+    }
+    TASK_END(t);
+}
+
+/**
+ * @brief Busca la zona de la ultima posicion y su limite a esa hora
+ */
+static void zone_update(uint32_t utc_ms) {
+    const geofence_zone_t *zone = geofence_lookup(fix_latitude, fix_longitude);
+    fix_zone = zone ? zone->id : GEOFENCE_NO_ZONE;
+    fix_limit_cdb = zone ? geofence_limit_cdb(zone, utc_ms) : 0;
+}
+
+/**
+ * @brief Acumula un bloque del DMA en la medicion manual
+ *
+ * Se llama desde la interrupcion del DMA. Suma la energia AC de cada bloque,
+ * como la ventana del monitor, para que el nivel no dependa del offset DC
+ * del microfono, y pasa el bloque al clasificador como monitor_push_block().
+ * Cada MONITOR_LEVEL_BLOCKS bloques cuenta un nivel corto para L10/L50/L90,
+ * igual que el monitor.
+ */
+static void measure_block(const uint16_t *block, uint16_t count) {
+    block_stats_t stats;
+    kernel_block_stats(block, count, &stats);
+    classifier_push_block(block, count);
+    uint64_t energy = kernel_ac_energy(&stats);
+    measure_energy += energy;
+    measure_count += stats.valid;
+    measure_sum += stats.sum;
+
+    level_energy += energy;
+    level_count += stats.valid;
+    if (++level_blocks == MONITOR_LEVEL_BLOCKS) {
+        if (level_count) {
+            levels_add(&measure_levels, monitor_ms_to_cdb((uint32_t)(level_energy / level_count)));
+        }
+        level_energy = 0;
+        level_count = 0;
+        level_blocks = 0;
+    }
+}
+
+/**
+ * @brief Vacia el UART del GPS y publica EV_FIX con cada posicion nueva
+ */
+static void gps_task_fn(sched_task_t *t) {
+    TASK_BEGIN(t);
+    while (true) {
+        if (use_ubx) {
+            ubx_nav_t nav;
+            if (ubx_poll(&nav)) {
+                fix_latitude = ubx_e7_to_e6(nav.lat_e7);
+                fix_longitude = ubx_e7_to_e6(nav.lon_e7);
+                zone_update(ubx_time_of_day_ms(nav.itow));
+                sched_post(EV_FIX);
+            }
+        } else if (gps_poll(&fix_latitude, &fix_longitude)) {
+            zone_update(gps_time_of_day_ms());
+            sched_post(EV_FIX);
+        }
+        TASK_SLEEP(t, GPS_POLL_MS);
+    }
+    TASK_END(t);
+}
+
+/**
+ * @brief Indicaciones temporizadas de los LEDs al terminar una medicion
+ */
+static void led_task_fn(sched_task_t *t) {
+    TASK_BEGIN(t);
+    while (true) {
+        TASK_WAIT(t, EV_ABORT | EV_SAVED, SCHED_FOREVER);
+        led_set_state(LED_YELLOW, 0);
+        if (t->events & EV_ABORT) {
+            led_set_state(LED_RED, 1);
+            TASK_SLEEP(t, 3000);
+            led_set_state(LED_RED, 0);
+        } else {
+            led_set_state(LED_ORANGE, 1);
+            TASK_SLEEP(t, 500);
+            led_set_state(LED_ORANGE, 0);
+        }
+        led_set_state(LED_GREEN, 1);
+        sched_post(EV_LED_IDLE);
+    }
+    TASK_END(t);
+}
+
 /**
  * @brief Mide el ruido y lo guarda con la geolocalizacion
  *
- * This function reads the noise level using the ADC, obtains the GPS
- * coordinates, and stores the data in non-volatile memory. It also
- * manages the LED indicators to show the current state of the system.
+ * Waits for a button press, captures ten seconds of audio through the DMA
+ * at MONITOR_SAMPLE_RATE, waits for the next GPS fix and stores both in
+ * non-volatile memory. The level is the Leq of the AC energy over the whole
+ * capture, with the same reference as the continuous mode; Noise is the raw
+ * average, which is only the microphone DC offset. L10, L50 and L90 come
+ * from the ~78 short levels (one per MONITOR_LEVEL_BLOCKS blocks, ~128 ms)
+ * of the capture, as in the event header. The noise source class
+ * and its confidence come from the classifier average at the end of the
+ * capture (about the last 0.5 s), as at the end of a continuous mode event.
+ * The record uses the same field order as the continuous mode event header,
+ * followed by the class fields of the event footer.
+ * A new press during the measurement or while waiting for the GPS aborts it.
+ * The waits are scheduler waits, so GPS bytes keep being drained meanwhile.
+ */
+static void measure_task_fn(sched_task_t *t) {
+    TASK_BEGIN(t);
+    while (true) {
+        TASK_WAIT(t, EV_BUTTON, SCHED_FOREVER);
+
+        // Indicate start of measurement
+        led_set_state(LED_GREEN, 0);
+        led_set_state(LED_YELLOW, 1);
+
+        measure_energy = 0;
+        measure_count = 0;
+        measure_sum = 0;
+        levels_init(&measure_levels);
+        level_energy = 0;
+        level_count = 0;
+        level_blocks = 0;
+        classifier_init();
+        adc_dma_start(MONITOR_SAMPLE_RATE, measure_block);
+        TASK_WAIT(t, EV_BUTTON, MEASURE_MS);
+        adc_dma_stop();
+        if (!(t->events & EV_BUTTON)) {
+            // Wait for a fresh GPS fix
+            TASK_WAIT(t, EV_FIX | EV_BUTTON, SCHED_FOREVER);
+        }
+
+        if (t->events & EV_BUTTON) {
+            // Button pressed during measurement, abort and turn on red LED
+            sched_post(EV_ABORT);
+        } else {
+            // Store data, tagged with the regulated zone
+            uint32_t count = measure_count;
+            int32_t level_cdb = count ? monitor_ms_to_cdb((uint32_t)(measure_energy / count)) : 0;
+            char data[256];
+            char *p = data;
+            p += fmt_str(p, "Noise: ");
+            p += fmt_uint(p, count ? measure_sum / count : 0);
+            p += fmt_str(p, ", Level: ");
+            p += fmt_fixed(p, level_cdb, 2, 2);
+            p += fmt_str(p, " dB, Lat: ");
+            p += fmt_fixed(p, fix_latitude, 6, 6);
+            p += fmt_str(p, ", Lon: ");
+            p += fmt_fixed(p, fix_longitude, 6, 6);
+            p += fmt_str(p, ", Zone: ");
+            p += fmt_uint(p, fix_zone);
+            p += fmt_str(p, ", Limit: ");
+            p += fmt_fixed(p, fix_limit_cdb, 2, 2);
+            p += fmt_str(p, " dB, Exceeds: ");
+            p += fmt_uint(p, fix_zone != GEOFENCE_NO_ZONE && level_cdb > fix_limit_cdb);
+            p += fmt_str(p, ", L10: ");
+            p += fmt_fixed(p, levels_exceeded(&measure_levels, 10), 2, 2);
+            p += fmt_str(p, " dB, L50: ");
+            p += fmt_fixed(p, levels_exceeded(&measure_levels, 50), 2, 2);
+            p += fmt_str(p, " dB, L90: ");
+            p += fmt_fixed(p, levels_exceeded(&measure_levels, 90), 2, 2);
+            p += fmt_str(p, " dB");
+            uint8_t confidence;
+            p += fmt_str(p, ", Class: ");
+            p += fmt_str(p, classifier_result(&confidence));
+            p += fmt_str(p, ", Confidence: ");
+            p += fmt_uint(p, confidence);
+            fmt_str(p, "%\n");
+            memory_write(data);
+            sched_post(EV_SAVED);
+        }
+        TASK_WAIT(t, EV_LED_IDLE, SCHED_FOREVER);
+    }
+    TASK_END(t);
+}
+
+/**
+ * @brief Monitoreo continuo sin intervencion del usuario
+ *
+ * Guarda por partes los eventos disparados por el monitor y mantiene los
+ * LEDs de estado. La posicion la actualiza gps_task_fn.
  */
- 
-void measure_noise_level(void);
+static void monitor_task_fn(sched_task_t *t) {
+    TASK_BEGIN(t);
+    while (true) {
+        monitor_set_position(fix_latitude, fix_longitude);
+        monitor_set_zone(fix_zone, fix_limit_cdb);
+#if TRACE_MODE
+        trace_task();
+        led_set_state(LED_RED, trace_dropped() > 0 || ubx_rx_overruns() > 0);
+#else
+        monitor_task();
+        led_set_state(LED_ORANGE, monitor_busy());
+        led_set_state(LED_RED, monitor_overruns() > 0 || ubx_rx_overruns() > 0 || memory_dropped() > 0);
+#endif
+        TASK_SLEEP(t, MONITOR_POLL_MS);
+    }
+    TASK_END(t);
+}
+
+/**
+ * @brief Configura el modo continuo
+ *
+ * Keeps the ADC sampling without interruption and stores every loud event
+ * (pre- and post-trigger audio plus position) as it happens. The GPS is
+ * switched to binary UBX at 5 Hz when it answers, otherwise NMEA is used.
+ */
+static void continuous_monitoring_start(void) {
+    led_set_state(LED_YELLOW, 1);
+    use_ubx = ubx_init(UBX_MAX_RATE_HZ);
+#if TRACE_MODE
+    trace_start(MONITOR_SAMPLE_RATE, MIC_COUNT);
+#endif
+    if (MIC_COUNT > 1) {
+        // Round-robin over the microphones; the monitor gets their average
+        monitor_configure(MONITOR_THRESHOLD_DB, MONITOR_RISE_DB);
+        mics_start(MONITOR_SAMPLE_RATE, MIC_COUNT);
+    } else {
+        monitor_init(MONITOR_THRESHOLD_DB, MONITOR_RISE_DB);
+    }
+    sched_add(&monitor_task_handle, monitor_task_fn);
+}
 
 int main() {
     stdio_init_all();
@@ -47,89 +323,22 @@ int main() {
 
     led_set_state(LED_GREEN, 1); // Ready state
 
-    while (true) {
-        if (button_is_pressed()) {
-            measure_noise_level();
-        }
-        sleep_ms(100);
-    }
-
-    return 0;
-}
-
-void measure_noise_level() {
-    // Indicate start of measurement
-    led_set_state(LED_GREEN, 0);
-    led_set_state(LED_YELLOW, 1);
-
-    uint16_t noise_level = 0;
-    for (int i = 0; i < 10; i++) {
-        if (button_is_pressed()) {
-            // Button pressed during measurement, abort and turn on red LED
-            led_set_state(LED_YELLOW, 0);
-            led_set_state(LED_RED, 1);
-            sleep_ms(3000);
-            led_set_state(LED_RED, 0);
-            led_set_state(LED_GREEN, 1);
-            return;
-        }
-        noise_level += adc_read();
-        sleep_ms(1000); // Sample every second for 10 seconds
+    if (!geofence_init(geofence_data, GEOFENCE_DATA_WORDS)) {
+        printf("Error: zonas invalidas, se guarda sin zona.\n");
     }
-    noise_level /= 10; // Average value
-
-    // Get GPS data
-    char buffer[256];
-    bool gps_fix = false;
-    double latitude, longitude;
-
-    while (!gps_fix) {
-        if (uart_is_readable(UART_ID)) {
-            char c = uart_getc(UART_ID);
-            static int index = 0;
-
-            if (c == '\n' || index >= sizeof(buffer) - 1) {
-                buffer[index] = '\0';
-
-                if (strstr(buffer, "$GPGGA") != NULL) {
-                    char time[10], lat[15], ns, lon[15], ew;
-                    int fix_quality;
-                    sscanf(buffer, "$GPGGA,%9[^,],%14[^,],%c,%14[^,],%c,%d", 
-                        time, lat, &ns, lon, &ew, &fix_quality);
-
-                    if (fix_quality > 0) {
-                        latitude = convert_to_decimal(lat, ns);
-                        longitude = convert_to_decimal(lon, ew);
-                        gps_fix = true;
-                    }
-                }
-
-                index = 0;
-            } else {
-                buffer[index++] = c;
-            }
-        }
 
-        if (button_is_pressed()) {
-            // Button pressed during GPS data reading, abort and turn on red LED
-            led_set_state(LED_YELLOW, 0);
-            led_set_state(LED_RED, 1);
-            sleep_ms(3000);
-            led_set_state(LED_RED, 0);
-            led_set_state(LED_GREEN, 1);
-            return;
-        }
+    sched_init();
+    sched_add(&gps_task, gps_task_fn);
+    if (button_is_pressed()) {
+        // Button held at power-up selects unattended continuous monitoring
+        continuous_monitoring_start();
+    } else {
+        sched_add(&button_task, button_task_fn);
+        sched_add(&led_task, led_task_fn);
+        sched_add(&measure_task, measure_task_fn);
     }
 
-    // Store data
-    char data[64];
-    snprintf(data, sizeof(data), "Noise: %u, Lat: %f, Lon: %f\n", noise_level, latitude, longitude);
-    memory_write(data);
-
-    // Indicate end of measurement
-    led_set_state(LED_YELLOW, 0);
-    led_set_state(LED_ORANGE, 1);
-    sleep_ms(500);
-    led_set_state(LED_ORANGE, 0);
-    led_set_state(LED_GREEN, 1);
-}
\ No newline at end of file
+    // Never returns; the CPU sleeps whenever no task is ready
+    sched_run();
+    return 0;
+}